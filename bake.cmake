@@ -0,0 +1,19 @@
+# frc_pathgen_bake(<target> <header name> <.path files...>)
+# Bakes the paths into a constexpr header (see include/baked_trajectory.hpp) at build time
+# and puts it on <target>'s include path. The static_asserts in the header check every
+# profile against its limits when <target> compiles.
+function(frc_pathgen_bake TARGET HEADER)
+  set(BAKED_DIR ${CMAKE_CURRENT_BINARY_DIR}/baked)
+  set(BAKED_HEADER ${BAKED_DIR}/${HEADER})
+
+  add_custom_command(
+    OUTPUT ${BAKED_HEADER}
+    COMMAND frc-pathgen --bake ${BAKED_HEADER} ${ARGN}
+    DEPENDS frc-pathgen ${ARGN}
+    WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}
+    COMMENT "Baking ${HEADER}"
+  )
+
+  target_sources(${TARGET} PRIVATE ${BAKED_HEADER})
+  target_include_directories(${TARGET} PRIVATE ${BAKED_DIR} ${CMAKE_SOURCE_DIR}/include)
+endfunction()
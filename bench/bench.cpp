@@ -0,0 +1,121 @@
+/*
+* frc-pathgen/bench/bench.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "bench.hpp"
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace frc_pathgen {
+
+BenchSuite::BenchSuite(std::string filter, double sample_ms) : filter(std::move(filter)), sample_ms(sample_ms) {
+}
+
+bool BenchSuite::wants(std::string_view name) const {
+  return this->filter.empty() || name.find(this->filter) != std::string_view::npos;
+}
+
+void BenchSuite::record(const std::string &name, double *samples_ns, size_t count, uint64_t ops) {
+  if (count == 0) return;
+  std::sort(samples_ns, samples_ns + count);
+  this->results.push_back(BenchResult { name, samples_ns[count / 2], samples_ns[0], ops });
+  fmt::print("{:<40} {:>14.1f} ns/op {:>14.1f} min\n", name, samples_ns[count / 2], samples_ns[0]);
+}
+
+// one benchmark per line, so the reader below doesn't need a JSON library
+bool write_bench_json(const std::filesystem::path &path, const std::vector<BenchResult> &results) {
+  std::string out = "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult &r = results[i];
+    out += fmt::format("    {{\"name\": \"{}\", \"ns_per_op\": {:.3f}, \"min_ns_per_op\": {:.3f}, \"ops\": {}}}{}\n",
+      r.name, r.ns_per_op, r.min_ns_per_op, r.ops, i + 1 < results.size()? "," : "");
+  }
+  out += "  ]\n}\n";
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file << out;
+  if (!file) {
+    fmt::print(stderr, "could not write {}\n", path.u8string());
+    return false;
+  }
+  return true;
+}
+
+static bool read_number(const std::string &line, const char *key, double &out) {
+  size_t at = line.find(key);
+  if (at == std::string::npos) return false;
+  const char *begin = line.c_str() + at + std::char_traits<char>::length(key);
+  char *end = nullptr;
+  out = std::strtod(begin, &end);
+  return end != begin;
+}
+
+bool read_bench_json(const std::filesystem::path &path, std::vector<BenchResult> &results) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    fmt::print(stderr, "could not read {}\n", path.u8string());
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(in, line)) {
+    static const char NAME[] = "\"name\": \"";
+    size_t at = line.find(NAME);
+    if (at == std::string::npos) continue;
+    size_t begin = at + sizeof(NAME) - 1;
+    size_t end = line.find('"', begin);
+    if (end == std::string::npos) continue;
+
+    BenchResult r { line.substr(begin, end - begin), 0.0, 0.0, 0 };
+    double ops = 0.0;
+    if (!read_number(line, "\"ns_per_op\":", r.ns_per_op)) continue;
+    read_number(line, "\"min_ns_per_op\":", r.min_ns_per_op);
+    read_number(line, "\"ops\":", ops);
+    r.ops = (uint64_t)ops;
+    results.push_back(std::move(r));
+  }
+  return true;
+}
+
+size_t compare_bench(const std::vector<BenchResult> &baseline, const BenchSuite &suite, double tolerance) {
+  std::unordered_map<std::string, const BenchResult *> before;
+  for (const BenchResult &r : baseline) before[r.name] = &r;
+  std::unordered_set<std::string> ran;
+
+  size_t regressions = 0, added = 0, missing = 0;
+  fmt::print("{:<40} {:>14} {:>14} {:>9}\n", "benchmark", "baseline", "now", "change");
+  for (const BenchResult &r : suite.get_results()) {
+    ran.insert(r.name);
+    auto it = before.find(r.name);
+    if (it == before.end()) {
+      fmt::print("{:<40} {:>14} {:>14.1f} {:>9}\n", r.name, "-", r.ns_per_op, "new");
+      ++added;
+      continue;
+    }
+
+    double change = r.ns_per_op / it->second->ns_per_op - 1.0;
+    bool regressed = change > tolerance;
+    regressions += regressed;
+    fmt::print("{:<40} {:>14.1f} {:>14.1f} {:>+8.1f}%{}\n", r.name, it->second->ns_per_op, r.ns_per_op,
+      change * 100.0, regressed? "  REGRESSION" : "");
+  }
+
+  // renamed, removed, or skipped this run (no renderer)
+  for (const BenchResult &r : baseline) {
+    if (!suite.wants(r.name) || ran.count(r.name)) continue;
+    fmt::print("{:<40} {:>14.1f} {:>14} {:>9}\n", r.name, r.ns_per_op, "-", "missing");
+    ++missing;
+  }
+
+  fmt::print("{} regressions over {:.0f}%, {} new, {} missing\n", regressions, tolerance * 100.0, added, missing);
+  return regressions;
+}
+}
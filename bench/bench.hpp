@@ -0,0 +1,103 @@
+/*
+* frc-pathgen/bench/bench.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frc_pathgen {
+
+struct BenchResult {
+  std::string name;
+  double ns_per_op;     // median over the samples
+  double min_ns_per_op; // fastest sample
+  uint64_t ops;         // operations timed in total
+};
+
+// keeps the optimizer from dropping a result nobody reads
+inline void bench_keep(float value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "g"(value) : "memory");
+#else
+  static volatile float sink;
+  sink = value;
+  value = sink;
+#endif
+}
+
+// Each benchmark is timed in SAMPLES batches of at least sample_ms each, the batch size
+// found by doubling. The median batch is the result, so one preempted batch doesn't count.
+class BenchSuite {
+public:
+  static constexpr int SAMPLES = 11;
+
+  BenchSuite(std::string filter = "", double sample_ms = 5.0);
+
+  // skipped benchmarks don't run their setup either
+  bool wants(std::string_view name) const;
+
+  // body(n) does the operation n times
+  template<typename F>
+  void run(const std::string &name, F &&body) {
+    this->run(name, [] {}, body);
+  }
+
+  // for bodies that advance a simulation: reset() rebuilds its state before every batch,
+  // untimed, so every sample times the same stretch of it
+  template<typename R, typename F>
+  void run(const std::string &name, R &&reset, F &&body) {
+    if (!this->wants(name)) return;
+
+    uint64_t n = 1;
+    for (;;) {
+      reset();
+      double ns = time_ns(body, n);
+      if (ns >= this->sample_ms * 1e6 || n >= (1ull << 40)) break;
+      // jump most of the way there once the batch is long enough to trust
+      n = ns > 1e5? (uint64_t)(n * this->sample_ms * 1e6 / ns) + 1 : n * 2;
+    }
+
+    double samples[SAMPLES];
+    for (int s = 0; s < SAMPLES; ++s) {
+      reset();
+      samples[s] = time_ns(body, n) / n;
+    }
+    this->record(name, samples, SAMPLES, n * SAMPLES);
+  }
+
+  // for measurements taken elsewhere, one sample per entry. prints the result as it lands
+  void record(const std::string &name, double *samples_ns, size_t count, uint64_t ops);
+
+  inline const std::vector<BenchResult> &get_results() const { return this->results; }
+private:
+  template<typename F>
+  static double time_ns(F &body, uint64_t n) {
+    auto start = std::chrono::steady_clock::now();
+    body(n);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  std::string filter;
+  double sample_ms;
+  std::vector<BenchResult> results;
+};
+
+bool write_bench_json(const std::filesystem::path &path, const std::vector<BenchResult> &results);
+// reads what write_bench_json wrote
+bool read_bench_json(const std::filesystem::path &path, std::vector<BenchResult> &results);
+
+// prints both side by side, returns how many got slower than baseline * (1 + tolerance).
+// cases only one side has are listed as new or missing (baseline cases the suite's filter
+// leaves out aren't), they don't count as regressions
+size_t compare_bench(const std::vector<BenchResult> &baseline, const BenchSuite &suite, double tolerance);
+}
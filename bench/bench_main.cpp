@@ -0,0 +1,722 @@
+/*
+* frc-pathgen/bench/bench_main.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "bench.hpp"
+#include "edit_history.hpp"
+#include "trajectory.hpp"
+#include "path.hpp"
+#include "alloc_stats.hpp"
+#include "frame_arena.hpp"
+#include "gfx.hpp"
+#include "multi_robot.hpp"
+#include "path_follower.hpp"
+#include "path_optimizer.hpp"
+#include "path_preview.hpp"
+#include "resources.hpp"
+#include "robot_log.hpp"
+#include "robot.hpp"
+#include "routine.hpp"
+#include "scheduled_controller.hpp"
+#include "telemetry.hpp"
+#include "world.hpp"
+#include <spdlog/spdlog.h>
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace frc_pathgen;
+
+static const float SIM_DT = 0.001f; // 1 kHz, the rate batch simulations run at
+
+// an S-curve chain, so every segment has curvature limits for the passes to settle on
+static std::vector<std::unique_ptr<BezierPath>> make_chain(size_t count) {
+  std::vector<std::unique_ptr<BezierPath>> chain;
+  chain.reserve(count);
+  for (size_t k = 0; k < count; ++k) {
+    float x = 2.0f * k;
+    float side = (k % 2 == 0)? 1.0f : -1.0f;
+    chain.push_back(std::make_unique<BezierPath>(
+      Vec2 { x, 0 }, Vec2 { x + 0.5f, side }, Vec2 { x + 1.5f, side }, Vec2 { x + 2.0f, 0 }));
+  }
+  return chain;
+}
+
+// the app's demo path
+static BezierPath demo_path() {
+  return BezierPath({0,0},{0,6},{1,3},{1,5});
+}
+
+// SDL's software renderer into a surface, with the grid label atlas, no window needed
+struct Headless {
+  SDL_Surface *target = nullptr;
+  SDL_Renderer *renderer = nullptr;
+  TTF_Font *font = nullptr;
+  GlyphAtlas labels;
+  Viewport viewport;
+
+  bool open(int width, int height) {
+    TTF_Init();
+    this->target = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    this->renderer = this->target? SDL_CreateSoftwareRenderer(this->target) : nullptr;
+    if (!this->renderer) return false;
+
+    this->font = TTF_OpenFontRW(SDL_RWFromConstMem(resources::jetbrains_mono_ttf, (int)resources::jetbrains_mono_ttf_size), 1, 14);
+    this->labels.build(this->renderer, this->font);
+
+    this->viewport.width = width;
+    this->viewport.height = height;
+    this->viewport.units_per_vw = 5;
+    return true;
+  }
+
+  ~Headless() {
+    this->labels.clear();
+    if (this->font) TTF_CloseFont(this->font);
+    if (this->renderer) SDL_DestroyRenderer(this->renderer);
+    if (this->target) SDL_FreeSurface(this->target);
+  }
+};
+
+static void bench_path(BenchSuite &suite) {
+  BezierPath path = demo_path();
+
+  suite.run("path.sample_position", [&](uint64_t n) {
+    float t = 0.0f, sum = 0.0f;
+    for (uint64_t i = 0; i < n; ++i) {
+      sum += path.sample_position(t).x;
+      t = t >= 1.0f? 0.0f : t + 1.0f / 1024.0f;
+    }
+    bench_keep(sum);
+  });
+
+  // per point, 1024 at a time
+  suite.run("path.sample_positions", [&](uint64_t n) {
+    static float t[1024];
+    static Vec2 out[1024];
+    for (int i = 0; i < 1024; ++i) t[i] = i / 1023.0f;
+    float sum = 0.0f;
+    for (uint64_t done = 0; done < n; done += 1024) {
+      size_t count = (size_t)std::min<uint64_t>(1024, n - done);
+      path.sample_positions(t, out, count);
+      sum += out[count - 1].x;
+    }
+    bench_keep(sum);
+  });
+
+  suite.run("path.max_acceleration", [&](uint64_t n) {
+    float sum = 0.0f;
+    for (uint64_t i = 0; i < n; ++i) sum += path.max_acceleration();
+    bench_keep(sum);
+  });
+
+  // what the trajectory pays per knot
+  QuinticHermitePath hermite({0,0}, {0,6}, {0,0}, {1,5}, {3,3}, {0,0});
+  ClothoidPath clothoid({0,0}, 1.5708f, 6.0f, 0.0f, 1.0f);
+  const std::pair<const char *, const Path *> kinds[] = {
+    { "path.sample_derivatives/bezier", &path },
+    { "path.sample_derivatives/hermite", &hermite },
+    { "path.sample_derivatives/clothoid", &clothoid },
+  };
+  for (auto &entry : kinds) {
+    const Path *kind = entry.second;
+    suite.run(entry.first, [&](uint64_t n) {
+      static float t[1024];
+      static PathPoint out[1024];
+      for (int i = 0; i < 1024; ++i) t[i] = i / 1023.0f;
+      float sum = 0.0f;
+      for (uint64_t done = 0; done < n; done += 1024) {
+        size_t count = (size_t)std::min<uint64_t>(1024, n - done);
+        kind->sample_derivatives(t, out, count);
+        sum += out[count - 1].kappa;
+      }
+      bench_keep(sum);
+    });
+  }
+}
+
+static void bench_trajectory(BenchSuite &suite) {
+  for (size_t count : { 8, 64, 512, 4096 }) {
+    std::string full = fmt::format("trajectory.set_segments/{}", count);
+    std::string edit = fmt::format("trajectory.update_segment/{}", count);
+    std::string turning = fmt::format("trajectory.turning/{}", count);
+    if (!suite.wants(full) && !suite.wants(edit) && !suite.wants(turning)) continue;
+
+    auto chain = make_chain(count);
+    std::vector<const Path *> segments;
+    for (auto &seg : chain) segments.push_back(seg.get());
+
+    Trajectory trajectory;
+    suite.run(full, [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) trajectory.set_segments(segments);
+    });
+
+    // a quarter turn on every segment, solved together with the translation
+    std::vector<HeadingWaypoint> headings;
+    for (size_t k = 0; k <= count; ++k) headings.push_back(HeadingWaypoint { (float)k, k % 2? 1.5708f : 0.0f });
+    suite.run(turning, [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) trajectory.set_segments(segments, headings);
+    });
+
+    // edit latency of one segment in the middle, the rest of the chain shouldn't matter
+    size_t mid = count / 2;
+    BezierPath &seg = *chain[mid];
+    Vec2 p1 = seg.get_control_point(1);
+    trajectory.set_segments(segments);
+    bool bumped = false;
+    suite.run(edit, [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) {
+        bumped = !bumped;
+        seg.set_control_point(1, p1 + Vec2 { 0, bumped? 0.25f : 0.0f });
+        trajectory.update_segment(mid);
+      }
+    });
+  }
+}
+
+static void bench_control(BenchSuite &suite) {
+  BezierPath path = demo_path();
+
+  if (suite.wants("follower.calc_vmax")) {
+    Robot robot;
+    PathFollower follower(robot);
+    follower.set_path(path);
+    suite.run("follower.calc_vmax", [&](uint64_t n) {
+      float t = 0.0f, sum = 0.0f;
+      for (uint64_t i = 0; i < n; ++i) {
+        sum += follower.calc_vmax(t);
+        t = t >= 1.0f? 0.0f : t + 1.0f / 1024.0f;
+      }
+      bench_keep(sum);
+    });
+  }
+
+  // the follower alone, the robot it commands doesn't move. both start over every batch
+  std::unique_ptr<Robot> robot;
+  std::unique_ptr<PathFollower> follower;
+  auto restart = [&] {
+    follower.reset();
+    robot = std::make_unique<Robot>();
+    follower = std::make_unique<PathFollower>(*robot);
+  };
+
+  if (suite.wants("follower.tick_path")) {
+    suite.run("follower.tick_path", [&] {
+      restart();
+      follower->set_path(path);
+    }, [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) follower->tick(SIM_DT);
+    });
+  }
+
+  if (suite.wants("follower.tick_routine")) {
+    Routine routine;
+    routine.add_path(path, Joint::STOP);
+    CompiledRoutine compiled = routine.compile({}, 0.02f);
+    suite.run("follower.tick_routine", [&] {
+      restart();
+      follower->set_routine(compiled);
+    }, [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) follower->tick(SIM_DT);
+    });
+    follower.reset();
+  }
+
+  // the schedule lookup on its own, and a whole controller update per robot and per eight
+  GainSchedule<> schedule = GainSchedule<>::sample(5.0f, 4.0f, [](float speed, float curvature) {
+    return ControllerGains { 20.0f, 0.0f, 15.0f * speed, 0.0f, 1.0f, curvature };
+  });
+  suite.run("control.gain_lookup", [&](uint64_t n) {
+    float speed = 0.0f, sum = 0.0f;
+    for (uint64_t i = 0; i < n; ++i) {
+      sum += schedule.at(speed, speed * 0.7f).kD;
+      speed = speed >= 6.0f? 0.0f : speed + 1.0f / 256.0f;
+    }
+    bench_keep(sum);
+  });
+
+  if (suite.wants("control.update")) {
+    ScheduledController<Vec2> controller(schedule);
+    suite.run("control.update", [&](uint64_t n) {
+      Vec2 current = { 0,0 }, sum = { 0,0 };
+      for (uint64_t i = 0; i < n; ++i) {
+        sum += controller.update(Vec2 { 1.0f, 2.0f }, current, Vec2 { 1.0f, 0.0f }, {}, 2.0f, 0.5f, SIM_DT);
+        current.x += 1e-4f;
+      }
+      bench_keep(sum.x);
+    });
+  }
+
+  if (suite.wants("control.update_x8")) {
+    ScheduledController<Vec2x8> controller(schedule);
+    float speeds[8] = { 0.0f, 0.5f, 1.0f, 1.5f, 2.0f, 3.0f, 4.0f, 5.5f };
+    floatx8 speed = packed_load<floatx8>(speeds), curvature = speed * 0.5f;
+    suite.run("control.update_x8", [&](uint64_t n) {
+      Vec2x8 current = { 0.0f, 0.0f }, sum = { 0.0f, 0.0f };
+      for (uint64_t i = 0; i < n; ++i) {
+        sum += controller.update(Vec2x8 { 1.0f, 2.0f }, current, Vec2x8 { 1.0f, 0.0f }, {}, speed, curvature, SIM_DT);
+        current.x += 1e-4f;
+      }
+      float lanes[8];
+      packed_store(sum.x, lanes);
+      bench_keep(lanes[0]);
+    });
+  }
+
+  if (suite.wants("robot.tick")) {
+    Robot robot;
+    robot.set_velocity_setpoint({ 1.0f, 0.5f });
+    robot.set_angular_velocity_setpoint(1.0f);
+    suite.run("robot.tick", [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) robot.tick(SIM_DT);
+      bench_keep(robot.get_frame_center().x);
+    });
+  }
+}
+
+static void bench_telemetry(BenchSuite &suite) {
+  suite.run("telemetry.push", [&](uint64_t n) {
+    static TelemetryChannel channel("bench", 0);
+    for (uint64_t i = 0; i < n; ++i) channel.push((float)(i & 1023));
+  });
+
+  // a plot's width of columns should cost the same for a second or an hour and a half at 1 kHz
+  constexpr size_t COLUMNS = 1600;
+  static MinMax columns[COLUMNS];
+  static bool valid[COLUMNS];
+  for (uint64_t count : { 1000, 600000, 6000000 }) {
+    std::string name = fmt::format("telemetry.decimate/{}", count);
+    if (!suite.wants(name)) continue;
+
+    TelemetryChannel channel("bench", 0);
+    for (uint64_t i = 0; i < count; ++i) channel.push(sinf(i * 0.01f) + ((i % 7919 == 0)? 5.0f : 0.0f));
+    suite.run(name, [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) {
+        channel.decimate(channel.oldest(), channel.size(), std::min<uint64_t>(COLUMNS, count), columns, valid);
+      }
+    });
+  }
+}
+
+// two lines of robots driving into each other, wide enough to keep the density about constant
+static void fill_crowd(MultiRobotWorld &world, size_t count, Vec2 origin = { 0,0 }) {
+  float spacing = 1.2f;
+  size_t per_side = (count + 1) / 2;
+  for (size_t k = 0; k < count; ++k) {
+    bool left = k < per_side;
+    float y = spacing * (float)(left? k : k - per_side);
+    uint32_t i = world.add_robot(origin + Vec2 { left? 0.0f : 8.0f, y }, 0.0f);
+    world.set_velocity_setpoint(i, { left? 2.0f : -2.0f, (k % 3 == 0)? 0.5f : 0.0f });
+    world.set_angular_velocity_setpoint(i, (k % 2 == 0)? 1.0f : -1.0f);
+  }
+}
+
+static void bench_multi_robot(BenchSuite &suite) {
+  for (size_t count : { 6, 64, 512, 4096 }) {
+    std::string name = fmt::format("multi_robot.tick/{}", count);
+    if (!suite.wants(name)) continue;
+
+    // the crowd collides and scatters, every batch starts from the same two lines
+    std::unique_ptr<MultiRobotWorld> world;
+    suite.run(name, [&] {
+      world = std::make_unique<MultiRobotWorld>();
+      fill_crowd(*world, count);
+    }, [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) world->tick(SIM_DT);
+    });
+  }
+
+  // every robot following the demo routine, spread out so they don't collide
+  for (size_t count : { 64, 512 }) {
+    std::string name = fmt::format("multi_robot.follow/{}", count);
+    if (!suite.wants(name)) continue;
+
+    BezierPath path = demo_path();
+    Routine routine;
+    routine.add_path(path, Joint::STOP);
+    CompiledRoutine compiled = routine.compile({}, 0.02f);
+    // from the start of the routine every batch, not wherever the last one left it
+    std::unique_ptr<MultiRobotWorld> world;
+    suite.run(name, [&] {
+      world = std::make_unique<MultiRobotWorld>();
+      for (size_t k = 0; k < count; ++k) {
+        Vec2 offset = { 3.0f * (float)(k % 32), 8.0f * (float)(k / 32) };
+        world->follow(world->add_robot(offset, 0.0f), &compiled, offset, 0.01f * (float)k);
+      }
+    }, [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) world->tick(SIM_DT);
+    });
+  }
+}
+
+static void bench_rendering(BenchSuite &suite, Headless &headless) {
+  FrameArena arena;
+
+  suite.run("world.gridlines", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      draw_world_gridlines(headless.renderer, headless.labels, arena, headless.viewport);
+      arena.reset();
+    }
+  });
+}
+
+// one library thumbnail on one worker, profile included
+static void bench_preview(BenchSuite &suite) {
+  if (!suite.wants("preview.rasterize")) return;
+
+  auto chain = make_chain(8);
+  PathPreviewSource source;
+  for (auto &seg : chain) source.segments.push_back(seg.get());
+  source.headings = { { 0.0f, 0.0f }, { 8.0f, 1.5708f } };
+
+  PathPreviewOptions options;
+  PathPreviewImage image;
+  suite.run("preview.rasterize", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      rasterize_path_preview(source, options, image);
+      bench_keep(image.pixels[image.pixels.size() / 2]);
+    }
+  });
+}
+
+// a 2.5 minute match logged at 1 kHz: a Pose2d, a double and a double[4] every 20 ms
+static bool write_test_wpilog(const std::filesystem::path &file) {
+  std::ofstream out(file, std::ios::binary);
+  auto raw = [&](const void *p, size_t n) { out.write(static_cast<const char *>(p), (std::streamsize)n); };
+  auto u32 = [&](uint32_t v) { raw(&v, 4); };
+  // 4 byte entry and size, 8 byte timestamp
+  auto record = [&](uint32_t entry, uint64_t timestamp, const void *payload, uint32_t size) {
+    uint8_t bits = 0x3 | (0x3 << 2) | (0x7 << 4);
+    raw(&bits, 1);
+    u32(entry);
+    u32(size);
+    raw(&timestamp, 8);
+    raw(payload, size);
+  };
+  auto start = [&](uint32_t entry, std::string_view name, std::string_view type) {
+    std::string payload(1, '\0');
+    payload.append(reinterpret_cast<const char *>(&entry), 4);
+    for (std::string_view s : { name, type, std::string_view() }) {
+      uint32_t length = (uint32_t)s.size();
+      payload.append(reinterpret_cast<const char *>(&length), 4);
+      payload.append(s);
+    }
+    record(0, 0, payload.data(), (uint32_t)payload.size());
+  };
+
+  raw("WPILOG", 6);
+  uint16_t version = 0x0100;
+  raw(&version, 2);
+  u32(0);
+  start(1, "/Robot/Pose", "struct:Pose2d");
+  start(2, "/Robot/Volts", "double");
+  start(3, "/Robot/ModuleSpeeds", "double[]");
+  for (uint64_t i = 0; i < 150000; ++i) {
+    double t = i * 1e-3;
+    double pose[3] = { 3.0 * cos(t * 0.5), 2.0 * sin(t * 0.5), t * 0.1 };
+    double volts = 12.0 + sin(t * 40.0);
+    record(1, i * 1000, pose, sizeof(pose));
+    record(2, i * 1000, &volts, sizeof(volts));
+    if (i % 20 == 0) {
+      double speeds[4] = { t, t + 1.0, t + 2.0, t + 3.0 };
+      record(3, i * 1000, speeds, sizeof(speeds));
+    }
+  }
+  return (bool)out;
+}
+
+static void bench_robot_log(BenchSuite &suite) {
+  if (!suite.wants("log.import_wpilog")) return;
+
+  std::error_code ec;
+  std::filesystem::path file = std::filesystem::temp_directory_path(ec) / "frc-pathgen-bench.wpilog";
+  if (ec || !write_test_wpilog(file)) {
+    fmt::print("log.import_wpilog skipped, could not write {}\n", file.u8string());
+    return;
+  }
+
+  RobotLogOptions options;
+  options.channels = { "/Robot/Pose.x", "/Robot/Pose.y", "/Robot/Pose.rotation", "/Robot/Volts" };
+  RobotLog log;
+  std::string error;
+  suite.run("log.import_wpilog", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      log.open(file, options, error);
+      bench_keep(log.get_columns().size());
+    }
+  });
+  std::filesystem::remove(file, ec);
+}
+
+// an edit to one path of a project, the project size shouldn't matter
+static void bench_history(BenchSuite &suite) {
+  for (size_t count : { 100, 10000 }) {
+    std::string name = fmt::format("history.commit/{}", count);
+    if (!suite.wants(name)) continue;
+
+    ProjectState project;
+    auto shape = std::make_shared<BezierPath>(demo_path());
+    for (size_t i = 0; i < count; ++i) project = project.with_added_path("p", shape);
+
+    EditHistory history(project, 1000);
+    size_t edit = 0;
+    suite.run(name, [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i, ++edit) {
+        auto moved = std::make_shared<BezierPath>(demo_path());
+        moved->set_control_point(1, Vec2 { 0.0f, 6.0f + (edit % 64) * 0.01f });
+        history.commit(history.current().with_path(edit * 7919 % count, std::move(moved)), "drag");
+      }
+    });
+  }
+
+  if (suite.wants("history.undo_redo")) {
+    ProjectState project;
+    project = project.with_added_path("p", std::make_shared<BezierPath>(demo_path()));
+    EditHistory history(project);
+    for (int i = 0; i < 64; ++i) history.commit(history.current().with_path(0, std::make_shared<BezierPath>(demo_path())), "drag");
+
+    suite.run("history.undo_redo", [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) {
+        if (!history.undo()) while (history.redo()) {}
+      }
+      bench_keep((float)history.current().paths[0]->geometry_hash);
+    });
+  }
+}
+
+// macro: the demo routine start to finish at 1 kHz, one op is the whole run
+static void bench_follower_sim(BenchSuite &suite) {
+  if (!suite.wants("sim.follower_routine")) return;
+
+  BezierPath path = demo_path();
+  Routine routine;
+  routine.add_path(path, Joint::STOP);
+  routine.add_wait(1.0f);
+  CompiledRoutine compiled = routine.compile({}, 0.02f);
+  int ticks = (int)((compiled.table.duration() + 1.0f) / SIM_DT);
+
+  suite.run("sim.follower_routine", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      Robot robot;
+      PathFollower follower(robot);
+      follower.set_routine(compiled);
+      for (int t = 0; t < ticks; ++t) {
+        robot.tick(SIM_DT);
+        follower.tick(SIM_DT);
+      }
+      bench_keep(robot.get_frame_center().y);
+    }
+  });
+}
+
+// macro: one interactive optimize click, the demo path around the defender and a smooth chain
+static void bench_optimizer(BenchSuite &suite) {
+  if (!suite.wants("optimizer.demo_path") && !suite.wants("optimizer.chain/8")) return;
+
+  PathOptimizer optimizer;
+  optimizer.set_obstacles({ Obstacle { { 0.6f, 3.2f }, Robot::frame_radius_m } });
+  suite.run("optimizer.demo_path", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      BezierPath path = demo_path();
+      bench_keep(optimizer.optimize({ &path }).final_time);
+    }
+  });
+
+  optimizer.set_obstacles({});
+  suite.run("optimizer.chain/8", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      auto chain = make_chain(8);
+      std::vector<BezierPath *> segments;
+      for (auto &seg : chain) segments.push_back(seg.get());
+      bench_keep(optimizer.optimize(segments).final_time);
+    }
+  });
+}
+
+// macro: what App::run does per frame minus ImGui, on the software renderer
+static void bench_frame(BenchSuite &suite, Headless &headless) {
+  if (!suite.wants("frame.headless")) return;
+
+  BezierPath path = demo_path();
+  Routine routine;
+  routine.add_path(path, Joint::STOP);
+  CompiledRoutine compiled = routine.compile({}, 0.02f);
+
+  // the routine, the crowd and the frame counter start over every batch
+  std::unique_ptr<Robot> robot;
+  std::unique_ptr<PathFollower> follower;
+  std::unique_ptr<MultiRobotWorld> field_robots;
+  FrameArena arena;
+
+  int frame = 0;
+  suite.run("frame.headless", [&] {
+    follower.reset();
+    robot = std::make_unique<Robot>();
+    follower = std::make_unique<PathFollower>(*robot);
+    follower->set_routine(compiled);
+    field_robots = std::make_unique<MultiRobotWorld>();
+    fill_crowd(*field_robots, 6, { -4.0f, 0.0f });
+    frame = 0;
+  }, [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i, ++frame) {
+      float dt = 1.0f / 60.0f;
+      robot->tick(dt);
+      follower->tick(dt);
+      field_robots->tick(dt);
+
+      headless.viewport.center = robot->get_frame_center();
+      SDL_SetRenderDrawColor(headless.renderer, 16, 16, 16, 255);
+      SDL_RenderClear(headless.renderer);
+      draw_world_gridlines(headless.renderer, headless.labels, arena, headless.viewport);
+      field_robots->draw(headless.renderer, headless.viewport);
+      draw_text(headless.renderer, headless.labels, arena.format("{}", frame), 14, 14);
+      SDL_RenderPresent(headless.renderer);
+      arena.reset();
+    }
+  });
+}
+
+// The parts of App::run that don't need a window or ImGui, on SDL's software renderer.
+// Steady state must not touch the heap, returns false (and says where) if it does.
+static bool check_frame_allocations() {
+  if (!alloc_stats::enabled) {
+    fmt::print("allocation check skipped, configure with -DFRC_PATHGEN_ALLOC_STATS=ON\n");
+    return true;
+  }
+
+  constexpr int WARMUP = 120;
+  constexpr int FRAMES = 600;
+
+  alloc_stats::install_sdl_hooks();
+
+  Headless headless;
+  if (!headless.open(1280, 720)) {
+    fmt::print("allocation check: no software renderer ({})\n", SDL_GetError());
+    return false;
+  }
+
+  BezierPath path = demo_path();
+  Routine routine;
+  routine.add_path(path, Joint::STOP);
+  routine.add_marker("start");
+  CompiledRoutine compiled = routine.compile({}, 0.02f);
+
+  Robot robot;
+  PathFollower follower(robot);
+  follower.set_routine(compiled);
+
+  FrameArena arena;
+  AllocCounts steady;
+
+  for (int frame = 0; frame < FRAMES; ++frame) {
+    float dt = 1.0f / 60.0f;
+    {
+      AllocScope scope(AllocSubsystem::PHYSICS);
+      robot.tick(dt);
+    }
+    {
+      AllocScope scope(AllocSubsystem::FOLLOWER);
+      follower.tick(dt);
+    }
+    {
+      AllocScope scope(AllocSubsystem::WORLD);
+      headless.viewport.center = robot.get_frame_center();
+      SDL_RenderClear(headless.renderer);
+      draw_world_gridlines(headless.renderer, headless.labels, arena, headless.viewport);
+      draw_text(headless.renderer, headless.labels, arena.format("{}", frame), 14, 14);
+      SDL_RenderPresent(headless.renderer);
+    }
+    arena.reset();
+
+    AllocCounts counts = alloc_stats::take();
+    if (frame < WARMUP) continue;
+    for (size_t i = 0; i < (size_t)AllocSubsystem::COUNT; ++i) {
+      steady.count[i] += counts.count[i];
+      steady.bytes[i] += counts.bytes[i];
+    }
+  }
+
+  fmt::print("allocation check: {} allocations over {} steady frames{}\n", steady.total(), FRAMES - WARMUP,
+    headless.font? "" : " (no font, labels not drawn)");
+  for (size_t i = 0; i < (size_t)AllocSubsystem::COUNT; ++i) {
+    if (steady.count[i]) fmt::print("  {}: {} allocations, {} bytes\n", alloc_subsystem_name((AllocSubsystem)i), steady.count[i], steady.bytes[i]);
+  }
+  return steady.total() == 0;
+}
+
+static void usage() {
+  fmt::print(
+    "usage: frc-pathgen-bench [options]\n"
+    "  --filter <text>       only benchmarks whose name contains text\n"
+    "  --json <out.json>     write the results\n"
+    "  --compare <base.json> compare against a stored run, exit 1 on regressions\n"
+    "  --tolerance <frac>    slowdown allowed by --compare (default 0.10)\n"
+    "  --sample-ms <ms>      minimum length of each timed batch (default 5)\n"
+    "  --alloc-check         fail on heap allocations in the steady-state frame loop\n");
+}
+
+int main(int argc, char **argv) {
+  std::string filter, json, baseline;
+  double tolerance = 0.10, sample_ms = 5.0;
+
+  for (int i = 1; i < argc; ++i) {
+    bool has_value = i + 1 < argc;
+    if (!std::strcmp(argv[i], "--alloc-check")) return check_frame_allocations()? 0 : 1;
+    else if (!std::strcmp(argv[i], "--filter") && has_value) filter = argv[++i];
+    else if (!std::strcmp(argv[i], "--json") && has_value) json = argv[++i];
+    else if (!std::strcmp(argv[i], "--compare") && has_value) baseline = argv[++i];
+    else if (!std::strcmp(argv[i], "--tolerance") && has_value) tolerance = std::atof(argv[++i]);
+    else if (!std::strcmp(argv[i], "--sample-ms") && has_value) sample_ms = std::atof(argv[++i]);
+    else {
+      usage();
+      return 2;
+    }
+  }
+
+  // the followers log every marker and decision, that's not what is being measured
+  spdlog::set_level(spdlog::level::warn);
+
+  // fail before spending a minute benchmarking
+  std::vector<BenchResult> before;
+  if (!baseline.empty() && !read_bench_json(baseline, before)) return 2;
+
+  BenchSuite suite(filter, sample_ms);
+
+  // micro
+  bench_path(suite);
+  bench_trajectory(suite);
+  bench_control(suite);
+  bench_telemetry(suite);
+  bench_multi_robot(suite);
+  bench_history(suite);
+  bench_preview(suite);
+  bench_robot_log(suite);
+
+  // macro
+  bench_follower_sim(suite);
+  bench_optimizer(suite);
+  if (suite.wants("world.gridlines") || suite.wants("frame.headless")) {
+    Headless headless;
+    if (headless.open(1280, 720)) {
+      bench_rendering(suite, headless);
+      bench_frame(suite, headless);
+    } else {
+      fmt::print("rendering benchmarks skipped, no software renderer ({})\n", SDL_GetError());
+    }
+  }
+
+  if (!json.empty() && !write_bench_json(json, suite.get_results())) return 2;
+  if (!baseline.empty()) return compare_bench(before, suite, tolerance) > 0? 1 : 0;
+  return 0;
+}
@@ -0,0 +1,30 @@
+# frc_pathgen_embed(<output.cpp> <symbol> <file>)
+# Generates a source defining frc_pathgen::resources::<symbol> (the bytes of <file>) and
+# <symbol>_size, declared in include/resources.hpp. Regenerated whenever <file> changes.
+# Running this file with cmake -P does the actual conversion.
+
+if(CMAKE_SCRIPT_MODE_FILE)
+  file(READ ${INPUT} HEX HEX)
+  string(LENGTH "${HEX}" HEX_LENGTH)
+  math(EXPR SIZE "${HEX_LENGTH} / 2")
+  string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX}")
+
+  file(WRITE ${OUTPUT}
+    "// generated from ${INPUT}, do not edit\n"
+    "#include \"resources.hpp\"\n"
+    "\n"
+    "namespace frc_pathgen::resources {\n"
+    "const unsigned char ${SYMBOL}[] = { ${BYTES} };\n"
+    "const size_t ${SYMBOL}_size = ${SIZE};\n"
+    "}\n")
+  return()
+endif()
+
+function(frc_pathgen_embed OUTPUT SYMBOL INPUT)
+  add_custom_command(
+    OUTPUT ${OUTPUT}
+    COMMAND ${CMAKE_COMMAND} -DINPUT=${INPUT} -DOUTPUT=${OUTPUT} -DSYMBOL=${SYMBOL} -P ${CMAKE_SOURCE_DIR}/embed.cmake
+    DEPENDS ${INPUT} ${CMAKE_SOURCE_DIR}/embed.cmake
+    COMMENT "Embedding ${INPUT}"
+  )
+endfunction()
@@ -0,0 +1,140 @@
+/*
+* frc-pathgen/impl/alloc_stats.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "alloc_stats.hpp"
+
+namespace frc_pathgen {
+
+const char *alloc_subsystem_name(AllocSubsystem subsystem) {
+  switch (subsystem) {
+  case AllocSubsystem::OTHER:    return "other";
+  case AllocSubsystem::EVENTS:   return "events";
+  case AllocSubsystem::PHYSICS:  return "physics";
+  case AllocSubsystem::WORLD:    return "world";
+  case AllocSubsystem::ROBOT:    return "robot";
+  case AllocSubsystem::FOLLOWER: return "follower";
+  case AllocSubsystem::PATH:     return "path";
+  case AllocSubsystem::UI:       return "ui";
+  default:                       return "?";
+  }
+}
+}
+
+#ifdef FRC_PATHGEN_ALLOC_STATS
+
+#include <SDL2/SDL.h>
+#include <imgui.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace frc_pathgen {
+
+static const size_t SUBSYSTEMS = (size_t)AllocSubsystem::COUNT;
+
+// plain atomics, worker threads allocate too
+static std::atomic<uint64_t> counts[SUBSYSTEMS];
+static std::atomic<uint64_t> bytes[SUBSYSTEMS];
+static thread_local AllocSubsystem current = AllocSubsystem::OTHER;
+
+static inline void record(size_t size) {
+  size_t i = (size_t)current;
+  counts[i].fetch_add(1, std::memory_order_relaxed);
+  bytes[i].fetch_add(size, std::memory_order_relaxed);
+}
+
+AllocScope::AllocScope(AllocSubsystem subsystem) : previous(current) {
+  current = subsystem;
+}
+
+AllocScope::~AllocScope() {
+  current = this->previous;
+}
+
+namespace alloc_stats {
+
+static SDL_malloc_func sdl_malloc;
+static SDL_calloc_func sdl_calloc;
+static SDL_realloc_func sdl_realloc;
+static SDL_free_func sdl_free;
+
+static void *counting_malloc(size_t size) {
+  record(size);
+  return sdl_malloc(size);
+}
+
+static void *counting_calloc(size_t count, size_t size) {
+  record(count * size);
+  return sdl_calloc(count, size);
+}
+
+static void *counting_realloc(void *p, size_t size) {
+  record(size);
+  return sdl_realloc(p, size);
+}
+
+void install_sdl_hooks() {
+  if (sdl_malloc) return;
+  SDL_GetMemoryFunctions(&sdl_malloc, &sdl_calloc, &sdl_realloc, &sdl_free);
+  SDL_SetMemoryFunctions(counting_malloc, counting_calloc, counting_realloc, sdl_free);
+}
+
+// ImGui's default is plain malloc/free, which the operator new replacement never sees
+static void *counting_imgui_alloc(size_t size, void *) {
+  record(size);
+  return std::malloc(size);
+}
+
+static void counting_imgui_free(void *p, void *) {
+  std::free(p);
+}
+
+void install_imgui_hooks() {
+  ImGui::SetAllocatorFunctions(counting_imgui_alloc, counting_imgui_free, nullptr);
+}
+
+AllocCounts take() {
+  AllocCounts out;
+  for (size_t i = 0; i < SUBSYSTEMS; ++i) {
+    out.count[i] = counts[i].exchange(0, std::memory_order_relaxed);
+    out.bytes[i] = bytes[i].exchange(0, std::memory_order_relaxed);
+  }
+  return out;
+}
+}
+}
+
+static void *counted_alloc(size_t size) {
+  frc_pathgen::record(size);
+  if (void *p = std::malloc(size? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+static void *counted_aligned_alloc(size_t size, std::align_val_t align) {
+  frc_pathgen::record(size);
+  size_t a = (size_t)align;
+  if (void *p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+  throw std::bad_alloc();
+}
+
+// the array, nothrow and sized forms all route through these by default
+void *operator new(size_t size) { return counted_alloc(size); }
+void *operator new[](size_t size) { return counted_alloc(size); }
+void *operator new(size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+void *operator new[](size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+#endif
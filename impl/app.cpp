@@ -16,15 +16,32 @@
 #include "SDL_timer.h"
 #include "world.hpp"
 #include "gfx.hpp"
+#include "resources.hpp"
+
+// TTF_SetFontSize lets one opened font render at several sizes
+#ifdef SDL_TTF_VERSION_ATLEAST
+#if SDL_TTF_VERSION_ATLEAST(2, 0, 18)
+#define FRC_PATHGEN_TTF_SET_SIZE 1
+#endif
+#endif
+#ifndef FRC_PATHGEN_TTF_SET_SIZE
+#define FRC_PATHGEN_TTF_SET_SIZE 0
+#endif
 
 namespace frc_pathgen {
 
 static const unsigned int WIDTH  = 1920;
 static const unsigned int HEIGHT = 1080;
 
+// first frames build ImGui's windows and SDL's render batches, the heap is fair game there
+static const uint64_t WARMUP_FRAMES = 120;
+
 App::App() : robot(), camera_controller(this->viewport, &this->robot), path_follower(this->robot), 
   path({0,0},{0,6},{1,3},{1,5}) {
   this->window = nullptr;
+  this->startup_begin = this->phase_begin = Clock::now();
+
+  alloc_stats::install_sdl_hooks();
 
   if (SDL_Init(SDL_INIT_VIDEO) < 0) {
     spdlog::error("SDL could not initialize! SDL_Error: {}", SDL_GetError());
@@ -35,6 +52,7 @@ App::App() : robot(), camera_controller(this->viewport, &this->robot), path_foll
   if (TTF_Init() == -1) {
     spdlog::warn("SDL_TTF could not initialize! SDL_Error: {}", TTF_GetError());
   }
+  this->log_startup_phase("sdl");
 
   this->window = SDL_CreateWindow("frc-pathgen",
     SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
@@ -49,10 +67,10 @@ App::App() : robot(), camera_controller(this->viewport, &this->robot), path_foll
   this->renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
   this->viewport.width = WIDTH;
   this->viewport.height = HEIGHT;
-
-  this->path_follower.set_path(this->path);
+  this->log_startup_phase("window");
 
   IMGUI_CHECKVERSION();
+  alloc_stats::install_imgui_hooks();
   ImGui::CreateContext();
   ImGui::StyleColorsDark();
 
@@ -60,23 +78,103 @@ App::App() : robot(), camera_controller(this->viewport, &this->robot), path_foll
   ImGui_ImplSDL2_InitForSDLRenderer(window, renderer);
   ImGui_ImplSDLRenderer2_Init(renderer);
 
-  char *exedir = SDL_GetBasePath();
   char *usrdir = SDL_GetPrefPath("FRC-8193", "frc-pathgen");
-
-  auto font_path = std::filesystem::path(exedir) / "resources/JetBrainsMono-Regular.ttf";
-  static auto imgui_ini_path = (std::filesystem::path(usrdir) / "imgui.ini").u8string();
-
-  spdlog::info("{}", imgui_ini_path.c_str());
+  this->data_dir = usrdir? usrdir : "";
+  static auto imgui_ini_path = (this->data_dir / "imgui.ini").u8string();
   SDL_free(usrdir);
-  SDL_free(exedir);
 
-  this->grid_font = TTF_OpenFont(font_path.u8string().c_str(), 14);
-  this->fps_font  = TTF_OpenFont(font_path.u8string().c_str(), 28);
+  spdlog::info("{}", imgui_ini_path.c_str());
 
   ImGuiIO &io = ImGui::GetIO();
 
   io.IniFilename = imgui_ini_path.c_str();
-  this->ui_font = io.Fonts->AddFontFromFileTTF(font_path.u8string().c_str());
+
+  // only registered here, the backend builds the atlas on the first NewFrame
+  ImFontConfig font_config;
+  font_config.FontDataOwnedByAtlas = false; // static data, ImGui must not free it
+  this->ui_font = io.Fonts->AddFontFromMemoryTTF(const_cast<unsigned char *>(resources::jetbrains_mono_ttf),
+    (int)resources::jetbrains_mono_ttf_size, 0.0f, &font_config);
+  this->log_startup_phase("imgui");
+
+  // one parse of the embedded font serves both sizes, the atlases keep everything they need
+  TTF_Font *font = TTF_OpenFontRW(SDL_RWFromConstMem(resources::jetbrains_mono_ttf, (int)resources::jetbrains_mono_ttf_size), 1, 14);
+  if (!font) spdlog::warn("Could not open embedded font: {}", TTF_GetError());
+
+  this->grid_labels.build(this->renderer, font);
+#if FRC_PATHGEN_TTF_SET_SIZE
+  if (font && TTF_SetFontSize(font, 28) == 0) this->fps_label.build(this->renderer, font);
+#else
+  if (font) TTF_CloseFont(font);
+  font = TTF_OpenFontRW(SDL_RWFromConstMem(resources::jetbrains_mono_ttf, (int)resources::jetbrains_mono_ttf_size), 1, 28);
+  this->fps_label.build(this->renderer, font);
+#endif
+  if (font) TTF_CloseFont(font);
+  this->log_startup_phase("text");
+}
+
+void App::log_startup_phase(const char *name) {
+  Clock::time_point now = Clock::now();
+  spdlog::info("Startup: {:<12} {:7.1f} ms", name, std::chrono::duration<double, std::milli>(now - this->phase_begin).count());
+  this->phase_begin = now;
+}
+
+// everything the first frame can do without, so the window shows up as soon as possible
+void App::init_deferred() {
+  this->initialized = true;
+
+  this->trajectory_cache = std::make_unique<TrajectoryCache>(default_trajectory_cache_dir());
+
+  // drop a field drawing in the data directory to get it behind the grid
+  std::error_code ec;
+  FieldMapOptions field;
+  field.image = this->data_dir / "field.bmp";
+  field.cache_dir = this->data_dir / "field_tiles";
+  if (std::filesystem::exists(field.image, ec)) this->field_map = std::make_unique<FieldMap>(std::move(field));
+  this->robot_log = std::make_unique<RobotLogOverlay>(this->data_dir / "robot.wpilog");
+
+  std::filesystem::path project_file = this->data_dir / "project.frcproj";
+  if (std::filesystem::exists(project_file, ec)) {
+    this->project = std::make_unique<ProjectFile>();
+    if (!this->project->open(project_file, this->project_error)) {
+      // the window still shows the error, with no rows to click
+      spdlog::error("{}: {}", project_file.u8string(), this->project_error);
+    } else {
+      spdlog::info("Project: {} paths, {} routines ({})", this->project->get_paths().size(), this->project->get_routines().size(),
+        this->project->used_index()? "indexed" : "scanned, run --index to skip that");
+      this->path_previews = std::make_unique<PathPreviews>();
+      this->preview_rows.resize(this->project->get_paths().size());
+    }
+  }
+
+  this->routine.add_path(this->path, Joint::STOP);
+  this->routine.add_heading(1.0f, PI * 0.5f); // turned a quarter by the end
+  this->routine.add_marker("start");
+  this->routine.add_wait(1.0f);
+  this->routine.add_marker("done", 1.0f);
+
+  ProjectState project;
+  project = project.with_added_path("demo", std::make_shared<BezierPath>(this->path));
+  project = project.with_added_step(ProjectStep { RoutineStep::PATH, 0, Joint::STOP });
+  project = project.with_added_step(ProjectStep { RoutineStep::WAIT, 0, Joint::STOP, 1.0f });
+  this->history = std::make_unique<EditHistory>(std::move(project));
+
+  this->compiled_routine = this->routine.compile({}, 0.02f, this->trajectory_cache.get());
+  this->sensors.reset(this->robot, this->pose_estimator);
+  this->path_follower.set_pose_estimator(&this->pose_estimator);
+  this->path_follower.set_routine(this->compiled_routine);
+
+  // partners run the same routine further down the field, the defender waits in our path
+  this->robot_proxy = this->field_robots.add_robot(this->robot.get_frame_center(), this->robot.get_rotation_radians(), true);
+  for (float x : { -3.0f, -1.5f, 1.5f, 3.0f, 4.5f }) {
+    uint32_t partner = this->field_robots.add_robot({ x, 0.0f }, 0.0f);
+    this->field_robots.follow(partner, &this->compiled_routine, { x, 0.0f });
+  }
+  this->defender = this->field_robots.add_robot({ 0.6f, 3.2f }, 0.4f);
+  spdlog::info("Routine: {:.2f}s, {} samples ({})", this->compiled_routine.table.duration(), this->compiled_routine.table.samples.size(),
+    this->trajectory_cache->get_hits() > 0? "cached" : "generated");
+
+  this->log_startup_phase("deferred");
+  spdlog::info("Startup: done after {:.1f} ms", std::chrono::duration<double, std::milli>(Clock::now() - this->startup_begin).count());
 }
 
 void App::run() {
@@ -107,59 +205,349 @@ void App::run() {
 
     ImGuiIO &io = ImGui::GetIO();
 
-    while (SDL_PollEvent(&e)) {
-      ImGui_ImplSDL2_ProcessEvent(&e);
-      if (io.WantCaptureKeyboard || io.WantCaptureMouse) continue;
-      if (this->camera_controller.consume_event(e)) continue;
-      if (this->path.consume_event(e)) continue;
-      if (e.type == SDL_WINDOWEVENT &&
-        e.window.event == SDL_WINDOWEVENT_RESIZED) {
-        int w = e.window.data1;
-        int h = e.window.data2;
-
-        SDL_RenderSetLogicalSize(renderer, w, h);
-        SDL_RenderSetViewport(renderer, NULL);
-
-        this->viewport.width = w;
-        this->viewport.height = h;
+    {
+      AllocScope scope(AllocSubsystem::EVENTS);
+      while (SDL_PollEvent(&e)) {
+        ImGui_ImplSDL2_ProcessEvent(&e);
+        if (io.WantCaptureKeyboard || io.WantCaptureMouse) continue;
+        if (this->camera_controller.consume_event(e)) continue;
+        if (this->consume_history_event(e)) continue;
+        if (this->path.consume_event(e)) continue;
+        if (e.type == SDL_WINDOWEVENT &&
+          e.window.event == SDL_WINDOWEVENT_RESIZED) {
+          int w = e.window.data1;
+          int h = e.window.data2;
+
+          SDL_RenderSetLogicalSize(renderer, w, h);
+          SDL_RenderSetViewport(renderer, NULL);
+
+          this->viewport.width = w;
+          this->viewport.height = h;
+        }
+        if (e.type == SDL_QUIT) running = false;
       }
-      if (e.type == SDL_QUIT) running = false;
     }
 
     // Physics stuff
-    this->robot.tick(dt);
-    this->camera_controller.tick(dt);
-    this->path_follower.tick(dt);
+    {
+      AllocScope scope(AllocSubsystem::PHYSICS);
+      this->robot.tick(dt);
+      if (this->initialized) {
+        this->sensors.tick(this->robot, dt, this->pose_estimator);
+        this->field_robots.set_pose(this->robot_proxy, this->robot.get_frame_center(), this->robot.get_rotation_radians(), this->robot.get_velocity());
+        this->field_robots.tick(dt);
+      }
+      this->camera_controller.tick(dt);
+    }
+    if (this->initialized) {
+      AllocScope scope(AllocSubsystem::FOLLOWER);
+      this->path_follower.tick(dt);
+    }
 
     // Rendering
-    SDL_SetRenderDrawColor(this->renderer, 16, 16, 16, 255);
-    SDL_RenderClear(this->renderer);
-
-    draw_world_gridlines(this->renderer, this->grid_font, this->viewport);
-    
-    ImGui_ImplSDLRenderer2_NewFrame();
-    ImGui_ImplSDL2_NewFrame();
-    ImGui::NewFrame();
-
-    this->robot.draw(this->renderer, this->viewport);
-    this->camera_controller.draw(this->renderer, this->viewport);
-    this->path_follower.draw(this->renderer, this->viewport);
-    this->path.draw(this->renderer, this->viewport);
-    
-    SDL_SetRenderDrawColor(this->renderer, 128, 128, 128, 255);
-    draw_text(this->renderer, this->fps_font, std::to_string((int)fps), 14, 14);
-    
-    ImGui::Render();
-    ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), this->renderer);
-
-    SDL_RenderPresent(this->renderer);
+    {
+      AllocScope scope(AllocSubsystem::WORLD);
+      SDL_SetRenderDrawColor(this->renderer, 16, 16, 16, 255);
+      SDL_RenderClear(this->renderer);
+
+      if (this->field_map) this->field_map->draw(this->renderer, this->viewport);
+      draw_world_gridlines(this->renderer, this->grid_labels, this->frame_arena, this->viewport);
+    }
+
+    {
+      AllocScope scope(AllocSubsystem::UI);
+      ImGui_ImplSDLRenderer2_NewFrame();
+      ImGui_ImplSDL2_NewFrame();
+      ImGui::NewFrame();
+    }
+
+    {
+      AllocScope scope(AllocSubsystem::ROBOT);
+      this->field_robots.draw(this->renderer, this->viewport);
+      this->robot.draw(this->renderer, this->viewport);
+      this->camera_controller.draw(this->renderer, this->viewport);
+    }
+    {
+      AllocScope scope(AllocSubsystem::FOLLOWER);
+      this->path_follower.draw(this->renderer, this->viewport);
+      this->sensors.draw(this->renderer, this->viewport, this->robot, this->pose_estimator);
+      if (this->robot_log) {
+        this->robot_log->draw(this->renderer, this->viewport, this->path_follower.get_time(),
+          this->robot.get_frame_center(), this->robot.get_rotation_radians());
+      }
+    }
+    {
+      AllocScope scope(AllocSubsystem::PATH);
+      this->path.draw(this->renderer, this->viewport);
+    }
+
+    {
+      AllocScope scope(AllocSubsystem::UI);
+      SDL_SetRenderDrawColor(this->renderer, 128, 128, 128, 255);
+      draw_text(this->renderer, this->fps_label, this->frame_arena.format("{}", (int)fps), 14, 14);
+
+      if (alloc_stats::enabled) this->draw_alloc_stats();
+      if (this->initialized) this->draw_optimizer();
+      if (this->project) this->draw_project();
+
+      ImGui::Render();
+      ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), this->renderer);
+
+      SDL_RenderPresent(this->renderer);
+    }
+
+    if (!this->initialized) {
+      this->log_startup_phase("first frame");
+      this->init_deferred();
+    }
+
+    this->end_frame();
   }
 
   this->teardown();
 }
 
+void App::end_frame() {
+  this->frame_arena.reset();
+  ++this->frame_index;
+
+  if (!alloc_stats::enabled) return;
+
+  this->frame_allocs = alloc_stats::take();
+  if (this->frame_index <= WARMUP_FRAMES) return;
+
+  // steady state should never allocate, report each offender once
+  bool logged = false;
+  for (size_t i = 0; i < (size_t)AllocSubsystem::COUNT; ++i) {
+    if (!this->frame_allocs.count[i] || this->alloc_reported[i]) continue;
+    this->alloc_reported[i] = true;
+    logged = true;
+    spdlog::warn("Frame {}: {} heap allocations ({} bytes) in {}", this->frame_index,
+      this->frame_allocs.count[i], this->frame_allocs.bytes[i], alloc_subsystem_name((AllocSubsystem)i));
+  }
+  // don't charge the logging to the next frame
+  if (logged) alloc_stats::take();
+}
+
+void App::draw_alloc_stats() {
+  ImGui::Begin("Allocations");
+  ImGui::Text("Frame %llu, %llu allocations", (unsigned long long)this->frame_index, (unsigned long long)this->frame_allocs.total());
+  for (size_t i = 0; i < (size_t)AllocSubsystem::COUNT; ++i) {
+    ImGui::Text("%-9s %6llu  %8llu B", alloc_subsystem_name((AllocSubsystem)i),
+      (unsigned long long)this->frame_allocs.count[i], (unsigned long long)this->frame_allocs.bytes[i]);
+  }
+  ImGui::Text("Arena     %zu / %zu B (peak %zu, %zu overflows)", this->frame_arena.get_used(),
+    this->frame_arena.get_capacity(), this->frame_arena.get_high_water(), this->frame_arena.get_overflows());
+  ImGui::End();
+}
+
+void App::start_optimizer() {
+  if (!this->path_optimizer) {
+    this->path_optimizer = std::make_unique<PathOptimizer>();
+    this->optimizer_worker = std::make_unique<ThreadPool>(1);
+  }
+
+  // wherever the defender has been pushed to by now
+  Obstacle defender = { this->field_robots.get_position(this->defender), Robot::frame_radius_m };
+  this->path_optimizer->set_obstacles({ defender });
+
+  std::shared_ptr<OptimizerJob> job = std::make_shared<OptimizerJob>(this->path);
+  this->optimizer_job = job;
+
+  PathOptimizer *optimizer = this->path_optimizer.get();
+  bool apply_unclear = this->optimizer_apply_unclear;
+  this->optimizer_worker->submit([job, optimizer, apply_unclear] {
+    job->result = optimizer->optimize({ &job->path }, apply_unclear);
+    job->done.store(true, std::memory_order_release);
+  });
+}
+
+void App::poll_optimizer() {
+  if (!this->optimizer_job || !this->optimizer_job->done.load(std::memory_order_acquire)) return;
+  std::shared_ptr<OptimizerJob> job = std::move(this->optimizer_job);
+  this->optimizer_result = job->result;
+  this->optimizer_ran = true;
+  if (!job->result.applied) return;
+
+  // an edit (or undo) while it ran wins, the result is for a path that's gone
+  for (int i = 0; i < 4; ++i) {
+    Vec2 p = this->path.get_control_point(i);
+    if (p.x != job->start[i].x || p.y != job->start[i].y) {
+      this->optimizer_result.applied = false;
+      spdlog::info("Path optimizer: the path changed while it ran, result dropped");
+      return;
+    }
+  }
+
+  for (int i = 1; i <= 2; ++i) this->path.set_control_point(i, job->path.get_control_point(i));
+  this->history->commit(this->history->current().with_path(0, std::make_shared<BezierPath>(this->path)), "minimize time");
+  this->recompile_routine();
+}
+
+void App::draw_optimizer() {
+  this->poll_optimizer();
+
+  ImGui::Begin("Path optimizer");
+  ImGui::BeginDisabled(this->optimizer_job != nullptr);
+  if (ImGui::Button("Minimize time")) this->start_optimizer();
+  ImGui::EndDisabled();
+  ImGui::SameLine();
+  ImGui::Checkbox("Apply if it clips", &this->optimizer_apply_unclear);
+
+  ImGui::BeginDisabled(!this->history->can_undo());
+  if (ImGui::Button("Undo") && this->history->undo()) this->load_history_state();
+  ImGui::EndDisabled();
+  ImGui::SameLine();
+  ImGui::BeginDisabled(!this->history->can_redo());
+  if (ImGui::Button("Redo") && this->history->redo()) this->load_history_state();
+  ImGui::EndDisabled();
+  ImGui::SameLine();
+  ImGui::Text("%zu states", this->history->depth());
+
+  if (this->optimizer_job) {
+    ImGui::TextUnformatted("Optimizing...");
+  } else if (this->optimizer_ran) {
+    const PathOptimizerResult &r = this->optimizer_result;
+    ImGui::Text("%.2f s -> %.2f s", r.initial_time, r.final_time);
+    ImGui::Text("%d iterations, %d profiles, %.0f ms", r.iterations, r.evaluations, r.seconds * 1e3);
+    if (!r.converged) ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "time budget ran out");
+    if (!r.clear) ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", r.applied? "still clips the defender" : "clips the defender, path left as it was");
+    else if (!r.applied) ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "the path was edited while it ran, not applied");
+  }
+  ImGui::End();
+}
+
+bool App::consume_history_event(SDL_Event &e) {
+  if (e.type != SDL_KEYDOWN || !this->history || !(e.key.keysym.mod & KMOD_CTRL)) return false;
+
+  bool moved;
+  if (e.key.keysym.sym == SDLK_z) moved = (e.key.keysym.mod & KMOD_SHIFT)? this->history->redo() : this->history->undo();
+  else if (e.key.keysym.sym == SDLK_y) moved = this->history->redo();
+  else return false;
+
+  if (moved) this->load_history_state();
+  return true;
+}
+
+void App::load_history_state() {
+  // the app only ever puts its BezierPath in
+  this->path = static_cast<const BezierPath &>(*this->history->current().paths[0]->path);
+  this->recompile_routine();
+}
+
+void App::recompile_routine() {
+  // `routine` points at `path`, which was changed in place
+  this->compiled_routine = this->routine.compile({}, 0.02f, this->trajectory_cache.get());
+  this->path_follower.set_routine(this->compiled_routine);
+}
+
+// project rows, names past the end are cut off. ids come from PushID, so a cut can't make two rows collide
+static const size_t ROW_LABEL_SIZE = 96;
+template<typename... Args>
+static void row_label(char (&label)[ROW_LABEL_SIZE], fmt::format_string<Args...> format, Args &&...args) {
+  *fmt::format_to_n(label, ROW_LABEL_SIZE - 1, format, std::forward<Args>(args)...).out = '\0';
+}
+
+void App::draw_project() {
+  ImGui::Begin("Project");
+  if (!this->project_error.empty()) ImGui::TextWrapped("%s", this->project_error.c_str());
+
+  const std::vector<ProjectBlock> &paths = this->project->get_paths();
+  const std::vector<ProjectBlock> &routines = this->project->get_routines();
+  ImGui::Text("%zu paths, %zu routines", paths.size(), routines.size());
+
+  if (this->path_previews) this->path_previews->begin_frame(this->renderer);
+
+  if (ImGui::CollapsingHeader("Paths")) {
+    ImVec2 preview_size = { 0, 0 };
+    if (this->path_previews) {
+      preview_size = ImVec2 { (float)this->path_previews->get_options().width, (float)this->path_previews->get_options().height };
+    }
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+      // only rows on screen get parsed and previewed, the rest are just their height
+      float duration = -1.0f;
+      if (this->path_previews) {
+        if (!ImGui::IsRectVisible(preview_size)) {
+          ImGui::Dummy(preview_size);
+          continue;
+        }
+
+        // the source is built once, after that a resident preview costs a hash map lookup
+        PreviewRow &row = this->preview_rows[i];
+        if (!row.built) {
+          std::string ignored;
+          const PathSpec *spec = this->project->load_path(i, ignored);
+          if (spec) {
+            row.source = PathPreviewSource { spec->segment_pointers(), spec->headings, spec->config };
+            row.key = PathPreviews::key_of(row.source);
+          }
+          row.built = true;
+          row.loaded = spec != nullptr;
+        }
+        SDL_Texture *texture = row.loaded? this->path_previews->get(row.key, row.source, &duration) : nullptr;
+        if (texture) ImGui::Image((ImTextureID)texture, preview_size);
+        else ImGui::Dummy(preview_size);
+        ImGui::SameLine();
+      }
+
+      char label[ROW_LABEL_SIZE];
+      if (duration >= 0.0f) row_label(label, "{:<24} {:.2f} s", paths[i].name, duration);
+      else row_label(label, "{:<24} line {}", paths[i].name, paths[i].line);
+      ImGui::PushID((int)i);
+      bool clicked = ImGui::Selectable(label);
+      ImGui::PopID();
+      if (!clicked) continue;
+
+      const PathSpec *spec = this->project->load_path(i, this->project_error);
+      if (!spec) continue;
+      this->project_error.clear();
+
+      Routine routine;
+      for (size_t k = 0; k < spec->segments.size(); ++k) {
+        routine.add_path(*spec->segments[k], k + 1 < spec->segments.size()? Joint::PASS_THROUGH : Joint::STOP);
+        spec->add_segment_headings(routine, k);
+      }
+      this->run_project_routine(std::move(routine), spec->config, spec->dt);
+    }
+  }
+
+  if (ImGui::CollapsingHeader("Routines")) {
+    ImGui::PushID("routines"); // row i here isn't path row i
+    for (size_t i = 0; i < routines.size(); ++i) {
+      char label[ROW_LABEL_SIZE];
+      row_label(label, "{:<24} line {}", routines[i].name, routines[i].line);
+      ImGui::PushID((int)i);
+      bool clicked = ImGui::Selectable(label);
+      ImGui::PopID();
+      if (!clicked) continue;
+
+      Routine routine;
+      if (!this->project->build_routine(i, routine, this->project_error)) continue;
+      this->project_error.clear();
+      this->run_project_routine(std::move(routine), this->project->get_config(), this->project->get_dt());
+    }
+    ImGui::PopID();
+  }
+
+  if (this->path_previews) this->path_previews->end_frame();
+  ImGui::End();
+}
+
+void App::run_project_routine(Routine routine, const TrajectoryConfig &config, float dt) {
+  // the paths stay loaded in `project`, the routine can point at them
+  this->project_routine = std::move(routine);
+  this->compiled_routine = this->project_routine.compile(config, dt, this->trajectory_cache.get());
+  this->path_follower.set_routine(this->compiled_routine);
+  spdlog::info("Project: running {:.2f}s, {} samples", this->compiled_routine.table.duration(), this->compiled_routine.table.samples.size());
+}
+
 void App::teardown() {
   if (!this->is_ok()) return;
+  this->grid_labels.clear();
+  this->fps_label.clear();
+  this->field_map.reset();
+  this->path_previews.reset();
   SDL_DestroyRenderer(this->renderer);
   SDL_DestroyWindow(this->window);
   SDL_Quit();
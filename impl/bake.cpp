@@ -0,0 +1,98 @@
+/*
+* frc-pathgen/impl/bake.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "bake.hpp"
+#include "path_io.hpp"
+#include <spdlog/fmt/fmt.h>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_set>
+
+namespace frc_pathgen {
+
+// file stem -> C++ identifier
+static std::string identifier(const std::string &name) {
+  std::string out;
+  for (char c : name) out += std::isalnum((unsigned char)c)? c : '_';
+  if (out.empty() || std::isdigit((unsigned char)out[0])) out = "path_" + out;
+  return out;
+}
+
+// always has a decimal point or exponent, so the f suffix is legal
+static std::string literal(float value) {
+  return fmt::format("{:#.9g}f", value);
+}
+
+int run_bake(const std::filesystem::path &header, const std::vector<std::filesystem::path> &inputs) {
+  std::string out =
+    "// generated by frc-pathgen --bake, do not edit\n"
+    "#pragma once\n"
+    "\n"
+    "#include \"baked_trajectory.hpp\"\n"
+    "\n"
+    "namespace frc_pathgen::baked {\n";
+
+  std::unordered_set<std::string> names;
+  for (const auto &file : inputs) {
+    PathSpec spec;
+    std::string error;
+    if (!load_path_file(file, spec, error)) {
+      fmt::print(stderr, "{}: {}\n", file.u8string(), error);
+      return 1;
+    }
+
+    std::string name = identifier(spec.name);
+    if (!names.insert(name).second) {
+      fmt::print(stderr, "{}: more than one path is named {}\n", file.u8string(), name);
+      return 1;
+    }
+
+    TrajectoryTable table = generate_trajectory(spec.segment_pointers(), spec.config, spec.dt, spec.headings);
+    if (table.samples.empty()) {
+      fmt::print(stderr, "{}: no segments\n", file.u8string());
+      return 1;
+    }
+
+    out += fmt::format("\n// {}: {:.2f} s, {} rows\n", file.filename().u8string(), table.duration(), table.samples.size());
+    out += fmt::format("inline constexpr float {}_dt = {};\n", name, literal(table.dt));
+    out += fmt::format("inline constexpr float {}_max_velocity = {};\n", name, literal(spec.config.max_velocity));
+    out += fmt::format("inline constexpr float {}_max_acceleration = {};\n", name, literal(spec.config.max_acceleration));
+    out += fmt::format("inline constexpr BakedSample {}[] = {{\n", name);
+    for (const TrajectorySample &s : table.samples) {
+      out += fmt::format("  {{ {}, {}, {}, {}, {}, {}, {} }},\n",
+        literal(s.time), literal(s.position.x), literal(s.position.y), literal(s.velocity.x), literal(s.velocity.y),
+        literal(s.heading), literal(s.omega));
+    }
+    out += "};\n";
+    out += fmt::format("static_assert(baked_within_limits({0}, {0}_max_velocity, {0}_max_acceleration), \"{0} breaks its limits\");\n", name);
+  }
+
+  out += "}\n";
+
+  // leave the file alone if nothing changed, the build would recompile everything that includes it
+  {
+    std::ifstream in(header, std::ios::binary);
+    if (in && std::string(std::istreambuf_iterator<char>(in), {}) == out) return 0;
+  }
+
+  std::error_code ec;
+  if (header.has_parent_path()) std::filesystem::create_directories(header.parent_path(), ec);
+
+  std::ofstream file(header, std::ios::binary | std::ios::trunc);
+  file << out;
+  if (!file) {
+    fmt::print(stderr, "could not write {}\n", header.u8string());
+    return 1;
+  }
+
+  fmt::print("baked {} paths into {}\n", inputs.size(), header.u8string());
+  return 0;
+}
+}
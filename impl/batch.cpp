@@ -0,0 +1,104 @@
+/*
+* frc-pathgen/impl/batch.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "batch.hpp"
+#include "path_io.hpp"
+#include "thread_pool.hpp"
+#include "trajectory_cache.hpp"
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace frc_pathgen {
+
+using Clock = std::chrono::steady_clock;
+
+int run_batch(const BatchOptions &options) {
+  std::error_code ec;
+  std::vector<std::filesystem::path> files;
+  for (auto &entry : std::filesystem::directory_iterator(options.input, ec)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".path") files.push_back(entry.path());
+  }
+  if (ec) {
+    fmt::print(stderr, "could not read {}: {}\n", options.input.u8string(), ec.message());
+    return 1;
+  }
+  std::sort(files.begin(), files.end());
+
+  std::filesystem::path output = options.output.empty()? options.input : options.output;
+  std::filesystem::create_directories(output, ec);
+
+  std::unique_ptr<TrajectoryCache> cache;
+  if (options.use_cache) cache = std::make_unique<TrajectoryCache>(default_trajectory_cache_dir());
+
+  ThreadPool pool(options.threads);
+  fmt::print("generating {} paths on {} threads\n", files.size(), pool.size());
+
+  std::mutex print_mutex;
+  std::atomic<size_t> done = 0, failed = 0, total_samples = 0;
+  std::atomic<int64_t> busy_ns = 0;
+
+  auto start = Clock::now();
+
+  for (const auto &file : files) {
+    pool.submit([&, file] {
+      auto job_start = Clock::now();
+
+      PathSpec spec;
+      std::string error;
+      bool ok = load_path_file(file, spec, error);
+
+      TrajectoryTable table;
+      if (ok) {
+        auto segments = spec.segment_pointers();
+        table = cache? cache->get_or_generate(segments, spec.config, spec.dt, spec.headings) :
+          generate_trajectory(segments, spec.config, spec.dt, spec.headings);
+
+        std::ofstream out(output / (spec.name + ".csv"), std::ios::binary | std::ios::trunc);
+        write_trajectory_csv(out, table);
+        if (!out) {
+          ok = false;
+          error = "could not write output";
+        }
+      }
+
+      auto job_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - job_start).count();
+      busy_ns += job_ns;
+      total_samples += table.samples.size();
+
+      std::lock_guard<std::mutex> lock(print_mutex);
+      size_t n = ++done;
+      if (ok) {
+        fmt::print("[{:>4}/{}] {:<32} {:>7.2f} s  {:>6} samples  {:>8.2f} ms\n",
+          n, files.size(), file.filename().u8string(), table.duration(), table.samples.size(), job_ns / 1e6);
+      } else {
+        ++failed;
+        fmt::print("[{:>4}/{}] {:<32} FAILED: {}\n", n, files.size(), file.filename().u8string(), error);
+      }
+      std::fflush(stdout);
+    });
+  }
+
+  pool.wait_idle();
+
+  double wall = std::chrono::duration<double>(Clock::now() - start).count();
+  double busy = busy_ns / 1e9;
+
+  fmt::print("\n{} paths ({} failed) in {:.3f} s wall, {:.3f} s cpu\n", files.size(), failed.load(), wall, busy);
+  fmt::print("{:.1f} paths/s, {:.0f} samples/s, {:.2f}x parallel speedup\n",
+    wall > 0.0? files.size() / wall : 0.0, wall > 0.0? total_samples / wall : 0.0, wall > 0.0? busy / wall : 0.0);
+  if (cache) fmt::print("cache: {} hits, {} misses\n", cache->get_hits(), cache->get_misses());
+
+  return failed > 0? 1 : 0;
+}
+}
@@ -0,0 +1,109 @@
+/*
+* frc-pathgen/impl/edit_history.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "edit_history.hpp"
+#include "hash.hpp"
+
+namespace frc_pathgen {
+
+static uint64_t geometry_hash(const Path &path) {
+  Hasher hasher;
+  path.hash_geometry(hasher);
+  return hasher.digest();
+}
+
+PathEntry make_path_entry(std::string name, std::shared_ptr<const Path> path, const TrajectoryConfig &config, float dt) {
+  PathEntry entry;
+  entry.name = std::move(name);
+  entry.geometry_hash = geometry_hash(*path);
+  entry.profile = std::make_shared<const TrajectoryTable>(generate_trajectory({ path.get() }, config, dt));
+  entry.path = std::move(path);
+  return entry;
+}
+
+ProjectState ProjectState::with_path(size_t index, std::shared_ptr<const Path> path) const {
+  const PathEntry &old = *this->paths[index];
+  auto entry = std::make_shared<PathEntry>();
+  entry->name = old.name;
+  entry->geometry_hash = geometry_hash(*path);
+  // same shape (a drag that came back to where it started), the profile still holds
+  entry->profile = entry->geometry_hash == old.geometry_hash? old.profile :
+    std::make_shared<const TrajectoryTable>(generate_trajectory({ path.get() }, this->config, this->dt));
+  entry->path = std::move(path);
+
+  ProjectState out = *this;
+  out.paths = this->paths.set(index, std::move(entry));
+  return out;
+}
+
+ProjectState ProjectState::with_added_path(std::string name, std::shared_ptr<const Path> path) const {
+  ProjectState out = *this;
+  out.paths = this->paths.push_back(std::make_shared<const PathEntry>(
+    make_path_entry(std::move(name), std::move(path), this->config, this->dt)));
+  return out;
+}
+
+ProjectState ProjectState::with_step(size_t index, ProjectStep step) const {
+  ProjectState out = *this;
+  out.steps = this->steps.set(index, step);
+  return out;
+}
+
+ProjectState ProjectState::with_added_step(ProjectStep step) const {
+  ProjectState out = *this;
+  out.steps = this->steps.push_back(step);
+  return out;
+}
+
+Routine ProjectState::routine() const {
+  Routine routine;
+  this->steps.for_each([&](const ProjectStep &step) {
+    if (step.kind == RoutineStep::WAIT) routine.add_wait(step.wait_seconds);
+    else if (step.path < this->paths.size()) routine.add_path(*this->paths[step.path]->path, step.joint);
+  });
+  return routine;
+}
+
+EditHistory::EditHistory(ProjectState initial, size_t max_depth) : max_depth(max_depth) {
+  this->states.push_back(Entry { std::move(initial), "" });
+}
+
+void EditHistory::commit(ProjectState next, std::string label) {
+  // releases only what no remaining state shares
+  this->states.erase(this->states.begin() + this->cursor + 1, this->states.end());
+  this->states.push_back(Entry { std::move(next), std::move(label) });
+  ++this->cursor;
+
+  if (this->max_depth > 0 && this->states.size() > this->max_depth) {
+    this->states.pop_front();
+    --this->cursor;
+  }
+}
+
+bool EditHistory::undo() {
+  if (!this->can_undo()) return false;
+  --this->cursor;
+  return true;
+}
+
+bool EditHistory::redo() {
+  if (!this->can_redo()) return false;
+  ++this->cursor;
+  return true;
+}
+
+const std::string &EditHistory::undo_label() const {
+  static const std::string NONE;
+  return this->can_undo()? this->states[this->cursor].label : NONE;
+}
+
+const std::string &EditHistory::redo_label() const {
+  static const std::string NONE;
+  return this->can_redo()? this->states[this->cursor + 1].label : NONE;
+}
+}
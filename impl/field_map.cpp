@@ -0,0 +1,315 @@
+/*
+* frc-pathgen/impl/field_map.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "field_map.hpp"
+#include "hash.hpp"
+#include <spdlog/spdlog.h>
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace frc_pathgen {
+
+static const int TILE = 256;
+// bump whenever the tile layout changes
+static const uint32_t PYRAMID_VERSION = 1;
+
+static inline uint64_t tile_key(int level, int x, int y) {
+  return ((uint64_t)level << 56) | ((uint64_t)(uint32_t)x << 28) | (uint64_t)(uint32_t)y;
+}
+
+static inline int key_level(uint64_t key) { return (int)(key >> 56); }
+static inline int key_x(uint64_t key) { return (int)((key >> 28) & 0xfffffff); }
+static inline int key_y(uint64_t key) { return (int)(key & 0xfffffff); }
+
+static inline int tiles_across(int pixels, int level) {
+  int scaled = (pixels + (1 << level) - 1) >> level;
+  return (scaled + TILE - 1) / TILE;
+}
+
+// 2x2 box filter, odd edges repeat the last row/column
+static SDL_Surface *downsample(SDL_Surface *src) {
+  int w = (src->w + 1) / 2, h = (src->h + 1) / 2;
+  SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGBA32);
+  if (!dst) return nullptr;
+
+  const uint8_t *in = static_cast<const uint8_t *>(src->pixels);
+  uint8_t *out = static_cast<uint8_t *>(dst->pixels);
+
+  for (int y = 0; y < h; ++y) {
+    const uint8_t *row0 = in + (2 * y) * src->pitch;
+    const uint8_t *row1 = in + std::min(2 * y + 1, src->h - 1) * src->pitch;
+    uint8_t *o = out + y * dst->pitch;
+
+    for (int x = 0; x < w; ++x) {
+      int x0 = 2 * x * 4, x1 = std::min(2 * x + 1, src->w - 1) * 4;
+      for (int c = 0; c < 4; ++c) {
+        o[4*x + c] = (uint8_t)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+      }
+    }
+  }
+  return dst;
+}
+
+FieldMap::FieldMap(FieldMapOptions options) : options(std::move(options)) {
+  std::error_code ec;
+  auto size = std::filesystem::file_size(this->options.image, ec);
+  auto mtime = std::filesystem::last_write_time(this->options.image, ec);
+
+  // a changed image gets a new directory, the old one is cleaned up after building
+  Hasher hasher;
+  hasher.add(PYRAMID_VERSION);
+  hasher.add(TILE);
+  std::string name = this->options.image.u8string();
+  hasher.update(name.data(), name.size());
+  hasher.add((uintmax_t)size);
+  hasher.add(mtime.time_since_epoch().count());
+  this->directory = this->options.cache_dir / fmt::format("{:016x}", hasher.digest());
+
+  this->wanted.reserve(64);
+  this->arrived.reserve(16);
+  this->queue.reserve(64);
+  this->loaded.reserve(16);
+
+  this->worker = std::thread(&FieldMap::work, this);
+}
+
+FieldMap::~FieldMap() {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopping = true;
+  }
+  this->wake.notify_all();
+  this->worker.join();
+
+  for (Loaded &l : this->loaded) {
+    if (l.surface) SDL_FreeSurface(l.surface);
+  }
+  for (auto &[key, tile] : this->resident) {
+    if (tile.texture) SDL_DestroyTexture(tile.texture);
+  }
+}
+
+std::filesystem::path FieldMap::tile_path(int level, int x, int y) const {
+  return this->directory / fmt::format("{}_{}_{}.bmp", level, x, y);
+}
+
+bool FieldMap::read_pyramid() {
+  std::ifstream in(this->directory / "pyramid.txt");
+  uint32_t version = 0;
+  if (!(in >> version >> this->image_width >> this->image_height >> this->levels)) return false;
+  return version == PYRAMID_VERSION && this->levels > 0;
+}
+
+bool FieldMap::build_pyramid() {
+  SDL_Surface *loaded = SDL_LoadBMP(this->options.image.u8string().c_str());
+  if (!loaded) {
+    spdlog::warn("Could not load field image {}: {}", this->options.image.u8string(), SDL_GetError());
+    return false;
+  }
+  SDL_Surface *level = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+  SDL_FreeSurface(loaded);
+  if (!level) return false;
+
+  std::error_code ec;
+  std::filesystem::create_directories(this->directory, ec);
+
+  int width = level->w, height = level->h;
+  int levels = 1;
+  while (std::max(width, height) > (TILE << (levels - 1))) ++levels;
+
+  spdlog::info("Building {} level field map from {}x{} image", levels, width, height);
+
+  // full size tiles, the padding past the image edge stays transparent
+  SDL_Surface *tile = SDL_CreateRGBSurfaceWithFormat(0, TILE, TILE, 32, SDL_PIXELFORMAT_RGBA32);
+  SDL_SetSurfaceBlendMode(level, SDL_BLENDMODE_NONE);
+
+  bool ok = tile != nullptr;
+  for (int l = 0; ok && l < levels; ++l) {
+    for (int ty = 0; ok && ty < tiles_across(height, l); ++ty) {
+      for (int tx = 0; ok && tx < tiles_across(width, l); ++tx) {
+        {
+          std::lock_guard<std::mutex> lock(this->mutex);
+          if (this->stopping) ok = false;
+        }
+
+        SDL_FillRect(tile, nullptr, 0);
+        SDL_Rect src = { tx * TILE, ty * TILE, TILE, TILE };
+        SDL_BlitSurface(level, &src, tile, nullptr);
+        if (ok && SDL_SaveBMP(tile, this->tile_path(l, tx, ty).u8string().c_str()) != 0) ok = false;
+      }
+    }
+
+    if (ok && l + 1 < levels) {
+      SDL_Surface *next = downsample(level);
+      SDL_FreeSurface(level);
+      level = next;
+      if (!level) ok = false;
+      else SDL_SetSurfaceBlendMode(level, SDL_BLENDMODE_NONE);
+    }
+  }
+
+  if (tile) SDL_FreeSurface(tile);
+  if (level) SDL_FreeSurface(level);
+  if (!ok) return false;
+
+  // written last, its presence means the pyramid is complete
+  {
+    std::ofstream out(this->directory / "pyramid.txt", std::ios::trunc);
+    out << PYRAMID_VERSION << ' ' << width << ' ' << height << ' ' << levels << '\n';
+  }
+
+  // pyramids of images that have since changed
+  for (auto &entry : std::filesystem::directory_iterator(this->options.cache_dir, ec)) {
+    if (entry.is_directory() && entry.path() != this->directory) std::filesystem::remove_all(entry.path(), ec);
+  }
+
+  return this->read_pyramid();
+}
+
+void FieldMap::work() {
+  if (!this->read_pyramid() && !this->build_pyramid()) return;
+  this->ready.store(true, std::memory_order_release);
+
+  for (;;) {
+    uint64_t key;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->wake.wait(lock, [this] { return this->stopping || !this->queue.empty(); });
+      if (this->stopping) return;
+
+      key = this->queue.back();
+      this->queue.pop_back();
+      this->loading = key;
+    }
+
+    SDL_Surface *surface = nullptr;
+    if (SDL_Surface *bmp = SDL_LoadBMP(this->tile_path(key_level(key), key_x(key), key_y(key)).u8string().c_str())) {
+      surface = SDL_ConvertSurfaceFormat(bmp, SDL_PIXELFORMAT_RGBA32, 0);
+      SDL_FreeSurface(bmp);
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->loaded.push_back(Loaded { key, surface });
+    this->loading = UINT64_MAX;
+  }
+}
+
+void FieldMap::upload(SDL_Renderer *r) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    size_t n = std::min(this->loaded.size(), (size_t)this->options.uploads_per_frame);
+    this->arrived.assign(this->loaded.begin(), this->loaded.begin() + n);
+    this->loaded.erase(this->loaded.begin(), this->loaded.begin() + n);
+  }
+
+  for (Loaded &l : this->arrived) {
+    SDL_Texture *texture = nullptr;
+    if (l.surface) {
+      texture = SDL_CreateTextureFromSurface(r, l.surface);
+      SDL_FreeSurface(l.surface);
+      if (texture) SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    }
+    if (!texture) spdlog::warn("Missing field map tile {}/{}/{}", key_level(l.key), key_x(l.key), key_y(l.key));
+    this->resident[l.key] = Tile { texture, this->frame };
+  }
+  this->arrived.clear();
+}
+
+bool FieldMap::draw_tile(SDL_Renderer *r, int level, int x, int y, const SDL_Rect &dst) {
+  for (int d = 0; level + d < this->levels; ++d) {
+    auto it = this->resident.find(tile_key(level + d, x >> d, y >> d));
+    if (it == this->resident.end() || !it->second.texture) continue;
+
+    int sub = TILE >> d;
+    if (sub == 0) return false;
+    SDL_Rect src = { (x & ((1 << d) - 1)) * sub, (y & ((1 << d) - 1)) * sub, sub, sub };
+    SDL_RenderCopy(r, it->second.texture, &src, &dst);
+    it->second.last_drawn = this->frame;
+    return d == 0;
+  }
+  return false;
+}
+
+void FieldMap::evict() {
+  if (this->resident.size() <= this->options.max_textures) return;
+
+  // never the ones drawn this frame, the budget only bounds what is off screen
+  this->eviction_order.clear();
+  for (auto &[key, tile] : this->resident) {
+    if (tile.last_drawn != this->frame) this->eviction_order.emplace_back(tile.last_drawn, key);
+  }
+  std::sort(this->eviction_order.begin(), this->eviction_order.end());
+
+  size_t excess = this->resident.size() - this->options.max_textures;
+  for (size_t i = 0; i < excess && i < this->eviction_order.size(); ++i) {
+    auto it = this->resident.find(this->eviction_order[i].second);
+    if (it->second.texture) SDL_DestroyTexture(it->second.texture);
+    this->resident.erase(it);
+  }
+}
+
+void FieldMap::draw(SDL_Renderer *r, const Viewport &vp) {
+  ++this->frame;
+  this->upload(r);
+  if (!this->is_ready()) return;
+
+  float screen_px_per_unit = vp.width / vp.units_per_vw;
+  float image_px_per_unit = this->image_width / this->options.size.x;
+  int level = (int)floorf(log2f(std::max(1.0f, image_px_per_unit / screen_px_per_unit)));
+  level = std::clamp(level, 0, this->levels - 1);
+
+  // level pixels <-> world
+  float scale = (float)(1 << level);
+  float world_per_px_x = this->options.size.x / this->image_width * scale;
+  float world_per_px_y = this->options.size.y / this->image_height * scale;
+  float top = this->options.origin.y + this->options.size.y;
+
+  Vec2 corner_a = vp.px_to_world({ 0, 0 });
+  Vec2 corner_b = vp.px_to_world({ (float)vp.width, (float)vp.height });
+
+  int x0 = std::max(0, (int)floorf((corner_a.x - this->options.origin.x) / world_per_px_x / TILE));
+  int x1 = std::min(tiles_across(this->image_width, level) - 1, (int)floorf((corner_b.x - this->options.origin.x) / world_per_px_x / TILE));
+  int y0 = std::max(0, (int)floorf((top - corner_a.y) / world_per_px_y / TILE));
+  int y1 = std::min(tiles_across(this->image_height, level) - 1, (int)floorf((top - corner_b.y) / world_per_px_y / TILE));
+
+  this->wanted.clear();
+  for (int ty = y0; ty <= y1; ++ty) {
+    for (int tx = x0; tx <= x1; ++tx) {
+      // neighbours round the same shared edge, so there are no seams
+      Vec2 a = vp.world_to_px({ this->options.origin.x + tx * TILE * world_per_px_x, top - ty * TILE * world_per_px_y });
+      Vec2 b = vp.world_to_px({ this->options.origin.x + (tx + 1) * TILE * world_per_px_x, top - (ty + 1) * TILE * world_per_px_y });
+      int left = (int)floorf(a.x), right = (int)floorf(b.x);
+      int upper = (int)floorf(a.y), lower = (int)floorf(b.y);
+      SDL_Rect dst = { left, upper, right - left, lower - upper };
+
+      uint64_t key = tile_key(level, tx, ty);
+      bool exact = this->draw_tile(r, level, tx, ty, dst);
+      if (!exact && !this->resident.count(key)) this->wanted.push_back(key);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // already on the way
+    this->wanted.erase(std::remove_if(this->wanted.begin(), this->wanted.end(), [this](uint64_t key) {
+      if (key == this->loading) return true;
+      for (const Loaded &l : this->loaded) if (l.key == key) return true;
+      return false;
+    }), this->wanted.end());
+
+    // replaces whatever was queued, tiles that scrolled away are not worth loading.
+    // reversed, so the worker (taking from the back) goes top left first
+    this->queue.assign(this->wanted.rbegin(), this->wanted.rend());
+  }
+  if (!this->wanted.empty()) this->wake.notify_one();
+
+  this->evict();
+}
+}
@@ -7,18 +7,90 @@
 */
 
 #include "gfx.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
 
 namespace frc_pathgen {
 
-void draw_text(SDL_Renderer *r, TTF_Font *font, const std::string &text, float x, float y) {
-  if (!font) return;
-  SDL_Color color = {200, 200, 200, 255};
-  SDL_Surface *surf = TTF_RenderText_Blended(font, text.c_str(), color);
-  SDL_Texture *tex = SDL_CreateTextureFromSurface(r, surf);
-  SDL_Rect dst = {(int)x, (int)y, surf->w, surf->h};
-  SDL_RenderCopy(r, tex, nullptr, &dst);
-  SDL_FreeSurface(surf);
-  SDL_DestroyTexture(tex);
+static const int ATLAS_WIDTH = 512;
+
+GlyphAtlas::~GlyphAtlas() {
+  this->clear();
+}
+
+void GlyphAtlas::clear() {
+  if (this->texture) SDL_DestroyTexture(this->texture);
+  this->texture = nullptr;
+}
+
+bool GlyphAtlas::build(SDL_Renderer *r, TTF_Font *font) {
+  this->clear();
+  if (!font) return false;
+
+  SDL_Color white = {255, 255, 255, 255};
+  SDL_Surface *rendered[LAST - FIRST + 1] = {};
+
+  // shelf packing, every glyph of one font has the same height
+  int x = 0, y = 0, shelf = 0;
+  for (int c = FIRST; c <= LAST; ++c) {
+    int i = c - FIRST;
+    TTF_GlyphMetrics(font, c, nullptr, nullptr, nullptr, nullptr, &this->advance[i]);
+
+    rendered[i] = TTF_RenderGlyph_Blended(font, c, white);
+    if (!rendered[i]) continue;
+
+    if (x + rendered[i]->w > ATLAS_WIDTH) {
+      x = 0;
+      y += shelf;
+      shelf = 0;
+    }
+    this->glyphs[i] = SDL_Rect { x, y, rendered[i]->w, rendered[i]->h };
+    x += rendered[i]->w;
+    shelf = std::max(shelf, rendered[i]->h);
+  }
+
+  SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, std::max(1, y + shelf), 32, SDL_PIXELFORMAT_RGBA32);
+  if (sheet) {
+    for (int i = 0; i <= LAST - FIRST; ++i) {
+      if (!rendered[i]) continue;
+      // straight copy, blending into the transparent sheet would halve the edges' alpha
+      SDL_SetSurfaceBlendMode(rendered[i], SDL_BLENDMODE_NONE);
+      SDL_BlitSurface(rendered[i], nullptr, sheet, &this->glyphs[i]);
+    }
+    this->texture = SDL_CreateTextureFromSurface(r, sheet);
+    SDL_FreeSurface(sheet);
+  }
+
+  for (SDL_Surface *s : rendered) {
+    if (s) SDL_FreeSurface(s);
+  }
+
+  if (!this->texture) {
+    spdlog::warn("Could not build glyph atlas: {}", SDL_GetError());
+    return false;
+  }
+
+  SDL_SetTextureBlendMode(this->texture, SDL_BLENDMODE_BLEND);
+  SDL_SetTextureColorMod(this->texture, 200, 200, 200);
+  return true;
+}
+
+void GlyphAtlas::draw(SDL_Renderer *r, std::string_view text, float x, float y) const {
+  if (!this->texture) return;
+
+  for (char c : text) {
+    int i = (unsigned char)c - FIRST;
+    if (i < 0 || i > LAST - FIRST) i = '?' - FIRST;
+
+    const SDL_Rect &src = this->glyphs[i];
+    SDL_Rect dst = {(int)x, (int)y, src.w, src.h};
+    SDL_RenderCopy(r, this->texture, &src, &dst);
+    x += this->advance[i];
+  }
+}
+
+void draw_text(SDL_Renderer *r, const GlyphAtlas &atlas, std::string_view text, float x, float y) {
+  atlas.draw(r, text, x, y);
 }
 
 void draw_arc(SDL_Renderer *r, int cx, int cy, float radius,
@@ -26,18 +98,18 @@ void draw_arc(SDL_Renderer *r, int cx, int cy, float radius,
 
   if (abs(start_angle - end_angle) < .01) return;
 
-  float step = (end_angle - start_angle) / segments;
-  for (int i = 0; i < segments; i++) {
-    float a0 = start_angle + i * step;
-    float a1 = a0 + step;
+  // one polyline call, on the stack so it never allocates
+  static const int MAX_SEGMENTS = 256;
+  segments = std::clamp(segments, 1, MAX_SEGMENTS);
+  SDL_FPoint points[MAX_SEGMENTS + 1];
 
-    int x0 = cx + (int)(cosf(a0) * radius);
-    int y0 = cy + (int)(sinf(a0) * radius);
-    int x1 = cx + (int)(cosf(a1) * radius);
-    int y1 = cy + (int)(sinf(a1) * radius);
-
-    SDL_RenderDrawLine(r, x0, y0, x1, y1);
+  float step = (end_angle - start_angle) / segments;
+  for (int i = 0; i <= segments; i++) {
+    float a = start_angle + i * step;
+    points[i] = SDL_FPoint { (float)(cx + (int)(cosf(a) * radius)), (float)(cy + (int)(sinf(a) * radius)) };
   }
+
+  SDL_RenderDrawLinesF(r, points, segments + 1);
 }
 
 void draw_filled_circle(SDL_Renderer *r, int cx, int cy, int radius) {
@@ -7,8 +7,118 @@
 */
 
 #include "app.hpp"
+#include "bake.hpp"
+#include "batch.hpp"
+#include "server.hpp"
+#include "path_io.hpp"
+#include "project_file.hpp"
+#include <spdlog/fmt/fmt.h>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static void print_usage(const char *exe) {
+  std::printf(
+    "usage: %s                          run the simulator\n"
+    "       %s --batch <dir> [options]  generate every .path file in <dir>\n"
+    "         -o <dir>      write the .csv tables here (default: next to the inputs)\n"
+    "         -j <threads>  worker threads (default: all cores)\n"
+    "         --no-cache    always regenerate\n"
+    "       %s --serve <socket> [options]  serve trajectories on a unix socket\n"
+    "         -j <connections>  concurrent connections\n"
+    "         --no-cache        skip the on-disk cache\n"
+    "       %s --query <socket> <file.path>  ask a running server, prints csv\n"
+    "       %s --bake <out.hpp> <file.path>...  write the paths as constexpr tables\n"
+    "       %s --index <file.frcproj>  rewrite a project's block index\n",
+    exe, exe, exe, exe, exe, exe);
+}
+
+// -j's thread or connection count, 0 for the default. far past any machine's cores is a typo
+static const unsigned int MAX_THREADS = 1024;
+
+static bool parse_threads(const char *text, unsigned int &out) {
+  const char *end = text + std::strlen(text);
+  auto result = std::from_chars(text, end, out);
+  if (result.ec == std::errc() && result.ptr == end && out <= MAX_THREADS) return true;
+  fmt::print(stderr, "-j takes a count from 0 to {}, not '{}'\n", MAX_THREADS, text);
+  return false;
+}
+
+static int batch_main(int argc, char **argv) {
+  frc_pathgen::BatchOptions options;
+  options.input = argv[2];
+
+  for (int i = 3; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "-o") && i + 1 < argc) options.output = argv[++i];
+    else if (!std::strcmp(argv[i], "-j") && i + 1 < argc) { if (!parse_threads(argv[++i], options.threads)) return 2; }
+    else if (!std::strcmp(argv[i], "--no-cache")) options.use_cache = false;
+    else {
+      print_usage(argv[0]);
+      return 2;
+    }
+  }
+
+  return frc_pathgen::run_batch(options);
+}
+
+static int serve_main(int argc, char **argv) {
+  frc_pathgen::ServerOptions options;
+  options.socket = argv[2];
+
+  for (int i = 3; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "-j") && i + 1 < argc) { if (!parse_threads(argv[++i], options.threads)) return 2; }
+    else if (!std::strcmp(argv[i], "--no-cache")) options.use_disk_cache = false;
+    else {
+      print_usage(argv[0]);
+      return 2;
+    }
+  }
+
+  return frc_pathgen::run_server(options);
+}
+
+static int query_main(int argc, char **argv) {
+  std::ifstream in(argv[3], std::ios::binary);
+  if (!in) {
+    fmt::print(stderr, "could not open {}\n", argv[3]);
+    return 1;
+  }
+  std::stringstream spec;
+  spec << in.rdbuf();
+
+  frc_pathgen::TrajectoryTable table;
+  std::string error;
+  if (!frc_pathgen::query_server(argv[2], spec.str(), table, error)) {
+    fmt::print(stderr, "{}\n", error);
+    return 1;
+  }
+
+  frc_pathgen::write_trajectory_csv(std::cout, table);
+  return 0;
+}
+
+static int bake_main(int argc, char **argv) {
+  std::vector<std::filesystem::path> inputs(argv + 3, argv + argc);
+  return frc_pathgen::run_bake(argv[2], inputs);
+}
 
 int main(int argc, char **argv) {
+  if (argc > 1) {
+    if (!std::strcmp(argv[1], "--batch") && argc > 2) return batch_main(argc, argv);
+    if (!std::strcmp(argv[1], "--serve") && argc > 2) return serve_main(argc, argv);
+    if (!std::strcmp(argv[1], "--query") && argc > 3) return query_main(argc, argv);
+    if (!std::strcmp(argv[1], "--bake") && argc > 3) return bake_main(argc, argv);
+    if (!std::strcmp(argv[1], "--index") && argc == 3) return frc_pathgen::run_index(argv[2]);
+
+    print_usage(argv[0]);
+    return std::strcmp(argv[1], "--help")? 2 : 0;
+  }
+
   frc_pathgen::App app;
 
   if (!app.is_ok()) return -1;
@@ -0,0 +1,362 @@
+/*
+* frc-pathgen/impl/multi_robot.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "multi_robot.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace frc_pathgen {
+
+// same loops as Robot
+static const float VELOCITY_KP = 50.0f;
+static const float ANGULAR_KP = 50.0f;
+static const float ANGULAR_KI = 0.5f;
+
+// followers' default gains, with the table's velocity as feedforward
+static const float POSITION_KP = 8.0f;
+static const float HEADING_KP = 7.5f;
+
+// bounce off each other a little
+static const float RESTITUTION = 0.2f;
+
+MultiRobotWorld::MultiRobotWorld() {
+  this->position_schedule = GainSchedule<>::constant(ControllerGains { POSITION_KP, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f });
+  this->heading_schedule = GainSchedule<>::constant(ControllerGains { HEADING_KP, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f });
+}
+
+uint32_t MultiRobotWorld::add_robot(Vec2 position, float heading, bool kinematic) {
+  uint32_t i = (uint32_t)this->x.size();
+
+  this->x.push_back(position.x);
+  this->y.push_back(position.y);
+  this->heading.push_back(heading);
+  this->vx.push_back(0.0f);
+  this->vy.push_back(0.0f);
+  this->omega.push_back(0.0f);
+  this->vx_setpoint.push_back(0.0f);
+  this->vy_setpoint.push_back(0.0f);
+  this->omega_setpoint.push_back(0.0f);
+  this->omega_integral.push_back(0.0f);
+  this->inverse_mass.push_back(kinematic? 0.0f : 1.0f / Robot::mass);
+  this->follows.emplace_back();
+  if (i % LANES == 0) {
+    this->position_controllers.emplace_back(this->position_schedule);
+    this->heading_controllers.emplace_back(this->heading_schedule);
+  }
+
+  this->min_x.push_back(0.0f);
+  this->max_x.push_back(0.0f);
+  this->min_y.push_back(0.0f);
+  this->max_y.push_back(0.0f);
+  this->order.push_back(i);
+  return i;
+}
+
+void MultiRobotWorld::clear() {
+  for (auto *v : { &this->x, &this->y, &this->heading, &this->vx, &this->vy, &this->omega,
+    &this->vx_setpoint, &this->vy_setpoint, &this->omega_setpoint, &this->omega_integral,
+    &this->inverse_mass, &this->min_x, &this->max_x, &this->min_y, &this->max_y }) v->clear();
+  this->follows.clear();
+  this->position_controllers.clear();
+  this->heading_controllers.clear();
+  this->order.clear();
+  this->sweep_axis = 0;
+  this->contacts.clear();
+  this->candidate_pairs = 0;
+}
+
+void MultiRobotWorld::set_velocity_setpoint(uint32_t i, Vec2 velocity) {
+  this->vx_setpoint[i] = velocity.x;
+  this->vy_setpoint[i] = velocity.y;
+}
+
+void MultiRobotWorld::set_angular_velocity_setpoint(uint32_t i, float angular_velocity) {
+  this->omega_setpoint[i] = angular_velocity;
+}
+
+void MultiRobotWorld::set_pose(uint32_t i, Vec2 position, float heading, Vec2 velocity) {
+  this->x[i] = position.x;
+  this->y[i] = position.y;
+  this->heading[i] = heading;
+  this->vx[i] = velocity.x;
+  this->vy[i] = velocity.y;
+}
+
+void MultiRobotWorld::follow(uint32_t i, const CompiledRoutine *routine, Vec2 offset, float start_time) {
+  this->follows[i] = Follow { routine, offset, start_time };
+  this->position_controllers[i / LANES].reset_lane(i % LANES);
+  this->heading_controllers[i / LANES].reset_lane(i % LANES);
+}
+
+void MultiRobotWorld::set_follower_schedules(const GainSchedule<> &position, const GainSchedule<> &heading) {
+  this->position_schedule = position;
+  this->heading_schedule = heading;
+  for (auto &controller : this->position_controllers) controller.schedule = position;
+  for (auto &controller : this->heading_controllers) controller.schedule = heading;
+}
+
+void MultiRobotWorld::tick(float dt) {
+  if (dt <= 0.0f || this->x.empty()) return;
+
+  this->follow_routines(dt);
+  this->integrate(dt);
+  this->sweep();
+  this->resolve();
+}
+
+// LANES robots at a time through one packed controller. lanes that aren't following get
+// their own pose as the target, so they add nothing and their setpoints are left alone
+void MultiRobotWorld::follow_routines(float dt) {
+  size_t n = this->x.size();
+  for (size_t group = 0; group * LANES < n; ++group) {
+    size_t base = group * LANES, count = std::min(LANES, n - base);
+
+    float target_x[LANES] = {}, target_y[LANES] = {}, rate_x[LANES] = {}, rate_y[LANES] = {};
+    float current_x[LANES] = {}, current_y[LANES] = {}, speed[LANES] = {}, curvature[LANES] = {};
+    float target_heading[LANES] = {}, current_heading[LANES] = {}, omega[LANES] = {};
+    bool following[LANES] = {}, any = false;
+    for (size_t l = 0; l < count; ++l) {
+      size_t i = base + l;
+      current_x[l] = target_x[l] = this->x[i];
+      current_y[l] = target_y[l] = this->y[i];
+      current_heading[l] = target_heading[l] = this->heading[i];
+      speed[l] = sqrtf(this->vx[i] * this->vx[i] + this->vy[i] * this->vy[i]);
+
+      Follow &f = this->follows[i];
+      if (!f.routine || f.routine->table.samples.empty()) continue;
+
+      // sit on the final pose for a second, then run it again
+      if (f.time > f.routine->table.duration() + 1.0f) f.time = 0.0f;
+      TrajectorySample sample = f.routine->table.at(f.time);
+      f.time += dt;
+
+      target_x[l] = sample.position.x + f.offset.x;
+      target_y[l] = sample.position.y + f.offset.y;
+      rate_x[l] = sample.velocity.x;
+      rate_y[l] = sample.velocity.y;
+      curvature[l] = sample.kappa;
+      // the short way round to the table's heading
+      float heading_error = sample.heading - this->heading[i];
+      target_heading[l] = this->heading[i] + atan2f(sinf(heading_error), cosf(heading_error));
+      omega[l] = sample.omega;
+      following[l] = any = true;
+    }
+
+    // an idle group starts over, its last measurements would be stale by the time it's used
+    if (!any) {
+      this->position_controllers[group].reset();
+      this->heading_controllers[group].reset();
+      continue;
+    }
+
+    floatx8 lane_speed = packed_load<floatx8>(speed), lane_curvature = packed_load<floatx8>(curvature);
+    Vec2x8 velocity = this->position_controllers[group].update(
+      Vec2x8 { packed_load<floatx8>(target_x), packed_load<floatx8>(target_y) },
+      Vec2x8 { packed_load<floatx8>(current_x), packed_load<floatx8>(current_y) },
+      Vec2x8 { packed_load<floatx8>(rate_x), packed_load<floatx8>(rate_y) }, {},
+      lane_speed, lane_curvature, dt);
+    floatx8 angular_velocity = this->heading_controllers[group].update(packed_load<floatx8>(target_heading),
+      packed_load<floatx8>(current_heading), packed_load<floatx8>(omega), 0.0f, lane_speed, lane_curvature, dt);
+
+    float out_x[LANES], out_y[LANES], out_omega[LANES];
+    packed_store(velocity.x, out_x);
+    packed_store(velocity.y, out_y);
+    packed_store(angular_velocity, out_omega);
+    for (size_t l = 0; l < count; ++l) {
+      if (!following[l]) continue;
+      this->vx_setpoint[base + l] = out_x[l];
+      this->vy_setpoint[base + l] = out_y[l];
+      this->omega_setpoint[base + l] = out_omega[l];
+    }
+  }
+}
+
+// Robot::tick and Robot::apply_voltages, one stage at a time over every robot
+void MultiRobotWorld::integrate(float dt) {
+  size_t n = this->x.size();
+  float damping = expf(-0.1f * dt);
+
+  for (size_t i = 0; i < n; ++i) {
+    if (this->inverse_mass[i] == 0.0f) continue;
+
+    float px = VELOCITY_KP * (this->vx_setpoint[i] - this->vx[i]) / 12.0f;
+    float py = VELOCITY_KP * (this->vy_setpoint[i] - this->vy[i]) / 12.0f;
+    float length = sqrtf(px*px + py*py);
+    float scale = length > 1.0f? 1.0f / length : 1.0f;
+    this->vx[i] += px * scale * Robot::bot_acceleration * dt;
+    this->vy[i] += py * scale * Robot::bot_acceleration * dt;
+
+    float error = this->omega_setpoint[i] - this->omega[i];
+    this->omega_integral[i] += error * dt;
+    float pr = (ANGULAR_KP * error + ANGULAR_KI * this->omega_integral[i]) / 12.0f;
+    pr = std::clamp(pr, -1.0f, 1.0f);
+    this->omega[i] += pr * Robot::bot_angular_acceleration * dt;
+
+    this->x[i] += this->vx[i] * dt;
+    this->y[i] += this->vy[i] * dt;
+    this->heading[i] += this->omega[i] * dt;
+
+    this->vx[i] *= damping;
+    this->vy[i] *= damping;
+    this->omega[i] *= damping;
+  }
+}
+
+void MultiRobotWorld::sweep() {
+  size_t n = this->x.size();
+  float hs = Robot::wheelbase_m / 2.0f;
+
+  for (size_t i = 0; i < n; ++i) {
+    // bounding box of the rotated square
+    float extent = hs * (fabsf(cosf(this->heading[i])) + fabsf(sinf(this->heading[i])));
+    this->min_x[i] = this->x[i] - extent;
+    this->max_x[i] = this->x[i] + extent;
+    this->min_y[i] = this->y[i] - extent;
+    this->max_y[i] = this->y[i] + extent;
+  }
+
+  // sweep along whichever axis the robots are spread out more on, a column of robots
+  // lined up in x would otherwise all overlap each other
+  float mean_x = 0.0f, mean_y = 0.0f, var_x = 0.0f, var_y = 0.0f;
+  for (size_t i = 0; i < n; ++i) {
+    mean_x += this->x[i];
+    mean_y += this->y[i];
+  }
+  mean_x /= n;
+  mean_y /= n;
+  for (size_t i = 0; i < n; ++i) {
+    var_x += (this->x[i] - mean_x) * (this->x[i] - mean_x);
+    var_y += (this->y[i] - mean_y) * (this->y[i] - mean_y);
+  }
+  int axis = var_y > var_x? 1 : 0;
+
+  const std::vector<float> &lo = axis == 0? this->min_x : this->min_y;
+  const std::vector<float> &hi = axis == 0? this->max_x : this->max_y;
+  const std::vector<float> &cross_lo = axis == 0? this->min_y : this->min_x;
+  const std::vector<float> &cross_hi = axis == 0? this->max_y : this->max_x;
+
+  if (axis != this->sweep_axis) {
+    this->sweep_axis = axis;
+    std::sort(this->order.begin(), this->order.end(), [&lo](uint32_t a, uint32_t b) { return lo[a] < lo[b]; });
+  } else {
+    // robots barely move between ticks, so the old order is nearly sorted already
+    for (size_t k = 1; k < n; ++k) {
+      uint32_t moving = this->order[k];
+      float key = lo[moving];
+      size_t j = k;
+      for (; j > 0 && lo[this->order[j - 1]] > key; --j) this->order[j] = this->order[j - 1];
+      this->order[j] = moving;
+    }
+  }
+
+  this->contacts.clear();
+  this->candidate_pairs = 0;
+  for (size_t k = 0; k < n; ++k) {
+    uint32_t a = this->order[k];
+    for (size_t m = k + 1; m < n; ++m) {
+      uint32_t b = this->order[m];
+      if (lo[b] > hi[a]) break;
+      if (cross_lo[b] > cross_hi[a] || cross_lo[a] > cross_hi[b]) continue;
+      if (this->inverse_mass[a] == 0.0f && this->inverse_mass[b] == 0.0f) continue;
+
+      ++this->candidate_pairs;
+      RobotContact contact;
+      if (this->separating_axis(a, b, contact)) this->contacts.push_back(contact);
+    }
+  }
+}
+
+// two squares of the same size, so the only candidate axes are each one's two edge normals
+bool MultiRobotWorld::separating_axis(uint32_t a, uint32_t b, RobotContact &contact) const {
+  float hs = Robot::wheelbase_m / 2.0f;
+  Vec2 d = { this->x[b] - this->x[a], this->y[b] - this->y[a] };
+
+  Vec2 axes[4];
+  axes[0] = { cosf(this->heading[a]), sinf(this->heading[a]) };
+  axes[1] = { -axes[0].y, axes[0].x };
+  axes[2] = { cosf(this->heading[b]), sinf(this->heading[b]) };
+  axes[3] = { -axes[2].y, axes[2].x };
+
+  contact.depth = INFINITY;
+  for (int k = 0; k < 4; ++k) {
+    Vec2 axis = axes[k];
+    // each square's half width projected on the axis
+    float ra = hs * (fabsf(Vec2::dot(axes[0], axis)) + fabsf(Vec2::dot(axes[1], axis)));
+    float rb = hs * (fabsf(Vec2::dot(axes[2], axis)) + fabsf(Vec2::dot(axes[3], axis)));
+    float distance = Vec2::dot(d, axis);
+    float overlap = ra + rb - fabsf(distance);
+    if (overlap <= 0.0f) return false;
+
+    if (overlap < contact.depth) {
+      contact.depth = overlap;
+      contact.normal = distance < 0.0f? axis * -1.0f : axis;
+    }
+  }
+
+  contact.a = a;
+  contact.b = b;
+  return true;
+}
+
+void MultiRobotWorld::resolve() {
+  for (const RobotContact &c : this->contacts) {
+    float wa = this->inverse_mass[c.a], wb = this->inverse_mass[c.b];
+    float w = wa + wb;
+
+    // push apart, the lighter one moves more
+    Vec2 push = c.normal * (c.depth / w);
+    this->x[c.a] -= push.x * wa;
+    this->y[c.a] -= push.y * wa;
+    this->x[c.b] += push.x * wb;
+    this->y[c.b] += push.y * wb;
+
+    float closing = (this->vx[c.b] - this->vx[c.a]) * c.normal.x + (this->vy[c.b] - this->vy[c.a]) * c.normal.y;
+    if (closing >= 0.0f) continue;
+
+    Vec2 impulse = c.normal * (-(1.0f + RESTITUTION) * closing / w);
+    this->vx[c.a] -= impulse.x * wa;
+    this->vy[c.a] -= impulse.y * wa;
+    this->vx[c.b] += impulse.x * wb;
+    this->vy[c.b] += impulse.y * wb;
+  }
+}
+
+void MultiRobotWorld::draw(SDL_Renderer *renderer, const Viewport &viewport) {
+  float hs = Robot::wheelbase_m / 2.0f;
+
+  for (uint32_t i = 0; i < this->x.size(); ++i) {
+    bool touching = false;
+    for (const RobotContact &c : this->contacts) touching |= c.a == i || c.b == i;
+
+    Vec2 center = { this->x[i], this->y[i] };
+    Vec2 f = { cosf(this->heading[i]), sinf(this->heading[i]) };
+    Vec2 l = { -f.y, f.x };
+    Vec2 corners[5] = {
+      center + (f + l) * hs,
+      center + (f - l) * hs,
+      center - (f + l) * hs,
+      center - (f - l) * hs,
+      center + (f + l) * hs,
+    };
+    SDL_FPoint points[5];
+    for (int k = 0; k < 5; ++k) {
+      Vec2 p = viewport.world_to_px(corners[k]);
+      points[k] = SDL_FPoint { p.x, p.y };
+    }
+
+    if (touching) SDL_SetRenderDrawColor(renderer, 255, 60, 60, 255);
+    else if (this->inverse_mass[i] == 0.0f) SDL_SetRenderDrawColor(renderer, 120, 120, 120, 255);
+    else SDL_SetRenderDrawColor(renderer, 80, 140, 255, 255);
+    SDL_RenderDrawLinesF(renderer, points, 5);
+
+    Vec2 cp = viewport.world_to_px(center);
+    Vec2 fp = viewport.world_to_px(center + f * hs);
+    SDL_RenderDrawLineF(renderer, cp.x, cp.y, fp.x, fp.y);
+  }
+}
+}
@@ -7,17 +7,74 @@
 */
 
 #include "path.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cmath>
 
 namespace frc_pathgen {
 
+static const float DERIVATIVE_EPS = .001;
+
+void Path::sample_positions(const float *t, Vec2 *out, size_t count) const {
+  for (size_t i = 0; i < count; ++i) out[i] = this->sample_position(t[i]);
+}
+
+Vec2 Path::sample_velocity(float t) const {
+  return (this->sample_position(t + DERIVATIVE_EPS) - this->sample_position(t - DERIVATIVE_EPS)) / (DERIVATIVE_EPS * 2.0f);
+}
+
+Vec2 Path::sample_acceleration(float t) const {
+  Vec2 last = this->sample_position(t - DERIVATIVE_EPS);
+  Vec2 current = this->sample_position(t);
+  Vec2 next = this->sample_position(t + DERIVATIVE_EPS);
+  return (next - 2.0f * current + last) / (DERIVATIVE_EPS * DERIVATIVE_EPS);
+}
+
+float Path::curvature(float t) const {
+  Vec2 v = this->sample_velocity(t);
+  float speed = v.length();
+  if (speed < 1e-6f) return 0.0f;
+  return Vec2::cross(v, this->sample_acceleration(t)) / (speed * speed * speed);
+}
+
+void Path::sample_derivatives(const float *t, PathPoint *out, size_t count) const {
+  for (size_t i = 0; i < count; ++i) {
+    out[i].position = this->sample_position(t[i]);
+    out[i].velocity = this->sample_velocity(t[i]);
+    out[i].kappa = this->curvature(t[i]);
+  }
+}
+
 Vec2 LinePath::sample_position(float t) const {
-  return (this->b - this->a) * (3.0f*t*t - 2.0f*t*t*t) + this->a;
+  return this->evaluate(t);
+}
+
+void LinePath::sample_positions(const float *t, Vec2 *out, size_t count) const {
+  sample_positions_packed(*this, t, out, count);
+}
+
+Vec2 LinePath::sample_velocity(float t) const {
+  return line_velocity(this->a, this->b, t);
+}
+
+Vec2 LinePath::sample_acceleration(float t) const {
+  return line_acceleration(this->a, this->b, t);
+}
+
+float LinePath::curvature(float t) const {
+  return 0.0f;
 }
 
 float LinePath::max_acceleration() const {
   return 6.0f * (this->b - this->a).length();
 }
 
+void LinePath::hash_geometry(Hasher &hasher) const {
+  hasher.add('L');
+  hasher.add(this->a);
+  hasher.add(this->b);
+}
+
 void LinePath::draw(SDL_Renderer *renderer, Viewport &viewport) {
   Vec2 ap = viewport.world_to_px(this->a);
   Vec2 bp = viewport.world_to_px(this->b);
@@ -31,7 +88,19 @@ bool LinePath::consume_event(SDL_Event &e) {
 }
 
 Vec2 BezierPath::sample_position(float t) const {
-  return powf(1.0f-t, 3.0f)*this->p0 + 3.0f*powf(1.0f-t, 2.0f)*t*this->p1 + 3.0f*(1.0f-t)*t*t*this->p2 + t*t*t*this->p3;
+  return this->evaluate(t);
+}
+
+void BezierPath::sample_positions(const float *t, Vec2 *out, size_t count) const {
+  sample_positions_packed(*this, t, out, count);
+}
+
+Vec2 BezierPath::sample_velocity(float t) const {
+  return bezier_velocity(this->p0, this->p1, this->p2, this->p3, t);
+}
+
+Vec2 BezierPath::sample_acceleration(float t) const {
+  return bezier_acceleration(this->p0, this->p1, this->p2, this->p3, t);
 }
 
 float BezierPath::max_acceleration() const {
@@ -53,6 +122,32 @@ float BezierPath::max_acceleration() const {
   return max_accel;
 }
 
+void BezierPath::hash_geometry(Hasher &hasher) const {
+  hasher.add('B');
+  hasher.add(this->p0);
+  hasher.add(this->p1);
+  hasher.add(this->p2);
+  hasher.add(this->p3);
+}
+
+Vec2 BezierPath::get_control_point(int i) const {
+  switch (i) {
+  case 0: return this->p0;
+  case 1: return this->p1;
+  case 2: return this->p2;
+  default: return this->p3;
+  }
+}
+
+void BezierPath::set_control_point(int i, Vec2 p) {
+  switch (i) {
+  case 0: this->p0 = p; break;
+  case 1: this->p1 = p; break;
+  case 2: this->p2 = p; break;
+  default: this->p3 = p; break;
+  }
+}
+
 void BezierPath::draw(SDL_Renderer *renderer, Viewport &viewport) {
   constexpr int STEPS = 256;
 
@@ -77,4 +172,154 @@ void BezierPath::draw(SDL_Renderer *renderer, Viewport &viewport) {
 bool BezierPath::consume_event(SDL_Event &e) {
   return false;
 }
+
+Vec2 QuinticHermitePath::sample_position(float t) const {
+  return this->evaluate(t);
+}
+
+void QuinticHermitePath::sample_positions(const float *t, Vec2 *out, size_t count) const {
+  sample_positions_packed(*this, t, out, count);
+}
+
+Vec2 QuinticHermitePath::sample_velocity(float t) const {
+  return hermite5_velocity(this->p0, this->v0, this->a0, this->p1, this->v1, this->a1, t);
+}
+
+Vec2 QuinticHermitePath::sample_acceleration(float t) const {
+  return hermite5_acceleration(this->p0, this->v0, this->a0, this->p1, this->v1, this->a1, t);
+}
+
+float QuinticHermitePath::max_acceleration() const {
+  constexpr int STEPS = 256;
+  float max_accel = 0.0f;
+
+  for (int i = 0; i <= STEPS; ++i) {
+    float t = (float)i / (float)STEPS;
+    max_accel = fmaxf(max_accel, this->sample_acceleration(t).length());
+  }
+
+  return max_accel;
+}
+
+void QuinticHermitePath::hash_geometry(Hasher &hasher) const {
+  hasher.add('Q');
+  hasher.add(this->p0);
+  hasher.add(this->v0);
+  hasher.add(this->a0);
+  hasher.add(this->p1);
+  hasher.add(this->v1);
+  hasher.add(this->a1);
+}
+
+void QuinticHermitePath::draw(SDL_Renderer *renderer, Viewport &viewport) {
+  constexpr int STEPS = 256;
+
+  Vec2 last = this->p0;
+
+  SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+
+  for (int i = 0; i <= STEPS; ++i) {
+    Vec2 p = this->sample_position((float)i / (float)STEPS);
+
+    Vec2 lp = viewport.world_to_px(last);
+    Vec2 pp = viewport.world_to_px(p);
+    last = p;
+
+    SDL_RenderDrawLineF(renderer, lp.x, lp.y, pp.x, pp.y);
+  }
+}
+
+ClothoidPath::ClothoidPath(Vec2 start, float heading, float length, float kappa_start, float kappa_end)
+  : start(start), heading(heading), length(fmaxf(length, 1e-6f)), kappa_start(kappa_start), kappa_end(kappa_end) {
+  this->sharpness = (this->kappa_end - this->kappa_start) / this->length;
+
+  // curvature is linear, so the largest |kappa| is at an end and bounds the turning
+  float turning = fmaxf(fabsf(this->kappa_start), fabsf(this->kappa_end)) * this->length;
+  // clamped as a float, the int cast of a huge, inf or NaN count is undefined
+  float panels = ceilf(turning / PANEL_TURN);
+  if (!(panels <= MAX_PANELS)) {
+    spdlog::warn("Clothoid turns up to {} rad, more than the {} it can integrate exactly, positions will drift", turning, MAX_TURNING);
+    panels = MAX_PANELS;
+  }
+  this->panels = std::max((int)panels, 1);
+  this->panel_length = this->length / this->panels;
+
+  // accumulate in double, the last panel start is the sum of all the others
+  double x = start.x, y = start.y;
+  this->panel_start[0] = start;
+  for (int i = 0; i < this->panels; ++i) {
+    Vec2 d = this->integrate(i * this->panel_length, (i + 1) * this->panel_length);
+    x += d.x;
+    y += d.y;
+    this->panel_start[i + 1] = Vec2 { (float)x, (float)y };
+  }
+}
+
+Vec2 ClothoidPath::integrate(float s0, float s1) const {
+  static const double NODES[5] = { -0.9061798459386640, -0.5384693101056831, 0.0, 0.5384693101056831, 0.9061798459386640 };
+  static const double WEIGHTS[5] = { 0.2369268850561891, 0.4786286704993665, 0.5688888888888889, 0.4786286704993665, 0.2369268850561891 };
+
+  double mid = 0.5 * ((double)s0 + s1), half = 0.5 * ((double)s1 - s0);
+  double x = 0.0, y = 0.0;
+  for (int i = 0; i < 5; ++i) {
+    double s = mid + half * NODES[i];
+    double theta = this->heading + this->kappa_start * s + 0.5 * this->sharpness * s * s;
+    x += WEIGHTS[i] * cos(theta);
+    y += WEIGHTS[i] * sin(theta);
+  }
+  return Vec2 { (float)(x * half), (float)(y * half) };
+}
+
+Vec2 ClothoidPath::sample_position(float t) const {
+  // t a little outside [0, 1] (difference stencils) extends the end panels
+  float s = t * this->length;
+  int panel = std::clamp((int)floorf(s / this->panel_length), 0, this->panels - 1);
+  float s0 = panel * this->panel_length;
+  return this->panel_start[panel] + this->integrate(s0, s);
+}
+
+Vec2 ClothoidPath::sample_velocity(float t) const {
+  float theta = this->heading_at(t);
+  return Vec2 { cosf(theta), sinf(theta) } * this->length;
+}
+
+Vec2 ClothoidPath::sample_acceleration(float t) const {
+  float theta = this->heading_at(t);
+  return Vec2 { -sinf(theta), cosf(theta) } * (this->length * this->length * this->curvature(t));
+}
+
+float ClothoidPath::curvature(float t) const {
+  return this->kappa_start + (this->kappa_end - this->kappa_start) * t;
+}
+
+float ClothoidPath::max_acceleration() const {
+  return this->length * this->length * fmaxf(fabsf(this->kappa_start), fabsf(this->kappa_end));
+}
+
+void ClothoidPath::hash_geometry(Hasher &hasher) const {
+  hasher.add('C');
+  hasher.add(this->start);
+  hasher.add(this->heading);
+  hasher.add(this->length);
+  hasher.add(this->kappa_start);
+  hasher.add(this->kappa_end);
+}
+
+void ClothoidPath::draw(SDL_Renderer *renderer, Viewport &viewport) {
+  constexpr int STEPS = 256;
+
+  Vec2 last = this->start;
+
+  SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+
+  for (int i = 0; i <= STEPS; ++i) {
+    Vec2 p = this->sample_position((float)i / (float)STEPS);
+
+    Vec2 lp = viewport.world_to_px(last);
+    Vec2 pp = viewport.world_to_px(p);
+    last = p;
+
+    SDL_RenderDrawLineF(renderer, lp.x, lp.y, pp.x, pp.y);
+  }
+}
 }
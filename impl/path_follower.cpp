@@ -8,18 +8,58 @@
 
 #include "path_follower.hpp"
 #include "gfx.hpp"
+#include "trajectory.hpp"
 #include <spdlog/spdlog.h>
 #include <imgui.h>
 #include <algorithm>
 
 namespace frc_pathgen {
 
-PathFollower::PathFollower(Robot &robot) : robot(robot), 
-  position_pid(20.0, 0.0, 2.0), angle_pid(7.5, 0.0, 1.5) {
+// past these the gains are held
+static const float SCHEDULE_MAX_SPEED = 5.0f;     // m/s
+static const float SCHEDULE_MAX_CURVATURE = 4.0f; // 1/m
+
+PathFollower::PathFollower(Robot &robot) : robot(robot) {
+  this->build_schedules();
+}
+
+void PathFollower::build_schedules() {
+  // more damping the faster the robot goes, the same at any curvature for now
+  this->position_controller.schedule = ScheduledController<Vec2>::Schedule::sample(SCHEDULE_MAX_SPEED, SCHEDULE_MAX_CURVATURE,
+    [this](float speed, float) { return ControllerGains { 20.0f, 0.0f, 15.0f * speed, 0.0f, this->feedforward, 0.0f }; });
+  this->angle_controller.schedule = ScheduledController<float>::Schedule::constant(ControllerGains { 7.5f, 0.0f, 1.5f, 0.0f, this->feedforward, 0.0f });
 }
 
 void PathFollower::set_path(Path &path) {
   this->path = &path;
+  this->routine = nullptr;
+}
+
+void PathFollower::set_routine(const CompiledRoutine &routine) {
+  this->routine = &routine;
+  this->time = this->elapsed = 0.0f;
+  this->marker_cursor = 0;
+  this->last_marker = nullptr;
+  this->position_controller.reset();
+  this->angle_controller.reset();
+}
+
+void PathFollower::set_marker_callback(std::function<void(const std::string &)> callback) {
+  this->marker_callback = std::move(callback);
+}
+
+void PathFollower::set_pose_estimator(const PoseEstimator *estimator) {
+  this->estimator = estimator;
+}
+
+Pose PathFollower::measured_pose() const {
+  if (this->estimator) return this->estimator->get_pose();
+  return Pose { this->robot.get_frame_center(), this->robot.get_rotation_radians() };
+}
+
+Vec2 PathFollower::measured_velocity() const {
+  if (this->estimator) return this->estimator->get_velocity();
+  return this->robot.get_velocity();
 }
 
 void PathFollower::draw(SDL_Renderer *renderer, const Viewport &viewport) {
@@ -31,45 +71,49 @@ void PathFollower::draw(SDL_Renderer *renderer, const Viewport &viewport) {
   SDL_RenderDrawLineF(renderer, tp.x, tp.y, gp.x, gp.y);
 
   ImGui::Begin("Path Following Controls");
-  ImGui::SliderFloat("Velocity Feedforward", &this->feedforward, 0.0f, 1.0f);
+  if (ImGui::SliderFloat("Velocity Feedforward", &this->feedforward, 0.0f, 1.0f)) this->build_schedules();
   ImGui::Text("Timescale %f", this->timescale);
   ImGui::Text("Curvature %f", this->kappa);
   ImGui::Text("Vtarg     %f", this->vtarg);
+  if (this->routine) {
+    ImGui::Text("Routine   %.2f / %.2f s", this->time, this->routine->table.duration());
+    ImGui::Text("Marker    %s", this->last_marker? this->last_marker->c_str() : "-");
+  }
+  if (ImGui::CollapsingHeader("History")) {
+    const TelemetryChannel *speeds[] = { &this->speed_target, &this->speed };
+    const TelemetryChannel *errors[] = { &this->tracking_error };
+    const TelemetryChannel *curvatures[] = { &this->curvature };
+    const TelemetryChannel *outputs[] = { &this->position_output, &this->heading_output };
+    this->speed_plot.draw("speed (m/s)", speeds, 2);
+    this->error_plot.draw("tracking", errors, 1);
+    this->curvature_plot.draw("curvature (1/m)", curvatures, 1);
+    this->output_plot.draw("pid out", outputs, 2);
+  }
   ImGui::End();
 }
 
 float PathFollower::calc_vmax(float t) {
-  static const float EPS = .001;
-  
-  Vec2 path_last    = this->path? this->path->sample_position(t-EPS) : Vec2 { 0,0 };
-  Vec2 path_current = this->path? this->path->sample_position(t) : Vec2 { 0,0 };
-  Vec2 path_next    = this->path? this->path->sample_position(t+EPS) : Vec2 { 0,0 };
-
-  Vec2 dpdt = (path_next-path_last) / (EPS * 2.0);
-  Vec2 d2pdt2 = (path_next - 2.0f * path_current + path_last) / (EPS * EPS);
-
-  this->kappa = Vec2::cross(dpdt, d2pdt2) / powf(dpdt.length(), 3.0f);
-  float vmax = 0.9 * sqrt(Robot::bot_acceleration / fmax(1e-4, fabsf(this->kappa)));
+  this->kappa = this->path? this->path->curvature(t) : 0.0f;
+  float vmax = curvature_vmax(this->kappa);
 
   return vmax;
 }
 
 void PathFollower::tick(float dt) {
-  static const float EPS = .001;
-  
+  if (this->routine) {
+    this->tick_routine(dt);
+    return;
+  }
+
   float t = this->time;
 
-  if (t > 1.0) this->time = 0.0;
+  if (t > 1.0) this->time = this->elapsed = 0.0f;
 
-  Vec2 path_last    = this->path? this->path->sample_position(t-EPS) : Vec2 { 0,0 };
   Vec2 path_current = this->path? this->path->sample_position(t) : Vec2 { 0,0 };
-  Vec2 path_next    = this->path? this->path->sample_position(t+EPS) : Vec2 { 0,0 };
+  Vec2 dpdt = this->path? this->path->sample_velocity(t) : Vec2 { 0,0 };
 
-  Vec2 dpdt = (path_next-path_last) / (EPS * 2.0);
-  Vec2 d2pdt2 = (path_next - 2.0f * path_current + path_last) / (EPS * EPS);
-
-  this->kappa = Vec2::cross(dpdt, d2pdt2) / powf(dpdt.length(), 3.0f);
-  float vmax = 0.9 * sqrt(Robot::bot_acceleration / fmax(1e-4, fabsf(this->kappa)));
+  this->kappa = this->path? this->path->curvature(t) : 0.0f;
+  float vmax = curvature_vmax(this->kappa);
   
   if (vmax > this->robot.get_velocity().length()) {
     this->vtarg = this->robot.get_velocity().length() + Robot::bot_acceleration * dt;
@@ -84,24 +128,74 @@ void PathFollower::tick(float dt) {
   
   Vec2 position_setpoint = path_current;
   
-  if ((position_setpoint - this->robot.get_frame_center()).length() > 0.1) this->time = 0.0f;
+  Pose pose = this->measured_pose();
+  if ((position_setpoint - pose.position).length() > 0.1) this->time = this->elapsed = 0.0f;
 
   this->target = position_setpoint;
   float angle_setpoint = 0.0;
 
   this->time += dt * this->timescale;
+  this->elapsed += dt;
 
-  Vec2 pos = this->robot.get_frame_center();
-  float angle = this->robot.get_rotation_radians();
-
-  this->position_pid.kD = 15.0 * this->robot.get_velocity().length();
+  this->steer(pose.position, angle_setpoint, pose.heading, 0.0f, dt);
+}
 
-  Vec2 velocity_setpoint = this->position_pid.update(position_setpoint, pos, dt) + this->feedforward * this->gradient;
-  float angular_velocity_setpoint = this->angle_pid.update(angle_setpoint, angle, dt);
+void PathFollower::steer(Vec2 position, float heading_setpoint, float heading, float omega, float dt) {
+  float speed = this->measured_velocity().length();
+  Vec2 velocity_setpoint = this->position_controller.update(this->target, position, this->gradient, {}, speed, this->kappa, dt);
+  float angular_velocity_setpoint = this->angle_controller.update(heading_setpoint, heading, omega, 0.0f, speed, this->kappa, dt);
 
   this->robot.set_velocity_setpoint(velocity_setpoint);
   this->robot.set_angular_velocity_setpoint(angular_velocity_setpoint);
+  this->record(position, velocity_setpoint, angular_velocity_setpoint);
+}
+void PathFollower::record(Vec2 position, Vec2 velocity_setpoint, float angular_velocity_setpoint) {
+  this->speed_target.push(this->vtarg);
+  this->speed.push(this->robot.get_velocity().length());
+  this->tracking_error.push((this->target - position).length());
+  this->curvature.push(this->kappa);
+  this->position_output.push(velocity_setpoint.length());
+  this->heading_output.push(angular_velocity_setpoint);
+}
+
+void PathFollower::tick_routine(float dt) {
+  const TrajectoryTable &table = this->routine->table;
+  if (table.samples.empty()) return;
+
+  // sit on the final pose for a second, then run it again
+  if (this->time > table.duration() + 1.0f) {
+    this->time = this->elapsed = 0.0f;
+    this->marker_cursor = 0;
+    this->position_controller.reset();
+    this->angle_controller.reset();
+  }
+
+  size_t row = this->routine->row(this->time);
+  uint32_t fire_end = this->routine->marker_start[row + 1];
+  for (; this->marker_cursor < fire_end; ++this->marker_cursor) {
+    this->last_marker = &this->routine->marker_names[this->marker_cursor];
+    spdlog::info("Marker '{}' at {:.2f}s", *this->last_marker, this->time);
+    if (this->marker_callback) this->marker_callback(*this->last_marker);
+  }
+
+  TrajectorySample sample = table.at(this->time);
+
+  this->target = sample.position;
+  this->gradient = sample.velocity;
+  this->kappa = sample.kappa;
+  this->vtarg = sample.velocity.length();
+  this->timescale = 1.0f;
+
+  this->time += dt;
+  this->elapsed += dt;
+
+  Pose pose = this->measured_pose();
+  // the table's heading is unwrapped, steer the short way to it. the measured heading is taken
+  // next to the table's, so it's as continuous as the table for the D term
+  float angle = sample.heading - atan2f(sinf(sample.heading - pose.heading), cosf(sample.heading - pose.heading));
+  this->steer(pose.position, sample.heading, angle, sample.omega, dt);
 }
+
 /*
 // newton-rhapson
 float PathFollower::find_nearest_t() {
@@ -0,0 +1,145 @@
+/*
+* frc-pathgen/impl/path_io.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "path_io.hpp"
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace frc_pathgen {
+
+std::vector<const Path *> PathSpec::segment_pointers() const {
+  std::vector<const Path *> out;
+  out.reserve(this->segments.size());
+  for (auto &segment : this->segments) out.push_back(segment.get());
+  return out;
+}
+
+void PathSpec::add_segment_headings(Routine &routine, size_t k) const {
+  for (const HeadingWaypoint &waypoint : this->headings) {
+    // the end of the last segment belongs to it
+    // clamped as a float, a u past size_t (or NaN) is undefined to cast
+    size_t segment = (size_t)fminf(fmaxf(waypoint.u, 0.0f), (float)(this->segments.size() - 1));
+    if (segment == k) routine.add_heading(waypoint.u - (float)k, waypoint.heading);
+  }
+}
+
+bool parse_float(std::string_view token, float &out) {
+  auto result = std::from_chars(token.data(), token.data() + token.size(), out);
+  // from_chars takes "inf" and "nan", nothing downstream wants them
+  return result.ec == std::errc() && result.ptr == token.data() + token.size() && std::isfinite(out);
+}
+
+bool parse_path_statement(std::string_view line, size_t line_number, PathSpec &spec, std::string &error) {
+  std::string_view tokens[13];
+  size_t count = split_statement(line, tokens);
+  if (count == 0) return true;
+
+  std::string_view keyword = tokens[0];
+  size_t expected = keyword == "hermite"? 13 : keyword == "bezier"? 9 : keyword == "clothoid"? 7 : keyword == "line"? 5 : keyword == "heading"? 3 : 2;
+  if (count != expected) {
+    error = fmt::format("line {}, column {}: '{}' takes {} values, got {}", line_number, column_of(line, keyword),
+      keyword, expected - 1, count - 1);
+    return false;
+  }
+
+  float v[12];
+  for (size_t i = 1; i < count; ++i) {
+    if (!parse_float(tokens[i], v[i-1])) {
+      error = fmt::format("line {}, column {}: '{}' is not a number", line_number, column_of(line, tokens[i]), tokens[i]);
+      return false;
+    }
+  }
+
+  if (keyword == "bezier") {
+    spec.segments.push_back(std::make_unique<BezierPath>(
+      Vec2 { v[0], v[1] }, Vec2 { v[2], v[3] }, Vec2 { v[4], v[5] }, Vec2 { v[6], v[7] }));
+  } else if (keyword == "hermite") {
+    spec.segments.push_back(std::make_unique<QuinticHermitePath>(
+      Vec2 { v[0], v[1] }, Vec2 { v[2], v[3] }, Vec2 { v[4], v[5] },
+      Vec2 { v[6], v[7] }, Vec2 { v[8], v[9] }, Vec2 { v[10], v[11] }));
+  } else if (keyword == "clothoid" && v[3] > 0.0f) {
+    float turning = fmaxf(fabsf(v[4]), fabsf(v[5])) * v[3];
+    if (turning > ClothoidPath::MAX_TURNING) {
+      error = fmt::format("line {}, column {}: clothoid curvature times length is {:.1f}, one segment holds at most {:.0f}, split it",
+        line_number, column_of(line, keyword), turning, ClothoidPath::MAX_TURNING);
+      return false;
+    }
+    spec.segments.push_back(std::make_unique<ClothoidPath>(Vec2 { v[0], v[1] }, v[2], v[3], v[4], v[5]));
+  } else if (keyword == "line") {
+    spec.segments.push_back(std::make_unique<LinePath>(Vec2 { v[0], v[1] }, Vec2 { v[2], v[3] }));
+  } else if (keyword == "heading" && v[0] >= 0.0f) {
+    spec.headings.push_back(HeadingWaypoint { v[0], v[1] });
+  } else if (keyword == "max_velocity" && v[0] > 0.0f) {
+    spec.config.max_velocity = v[0];
+  } else if (keyword == "max_acceleration" && v[0] > 0.0f) {
+    spec.config.max_acceleration = v[0];
+  } else if (keyword == "max_angular_acceleration" && v[0] > 0.0f) {
+    spec.config.max_angular_acceleration = v[0];
+  } else if (keyword == "curvature_margin" && v[0] > 0.0f && v[0] <= 1.0f) {
+    spec.config.curvature_margin = v[0];
+  } else if (keyword == "samples" && v[0] >= 2.0f && v[0] <= (float)MAX_SAMPLES_PER_SEGMENT) {
+    spec.config.samples_per_segment = (int)v[0];
+  } else if (keyword == "dt" && v[0] >= MIN_DT) {
+    spec.dt = v[0];
+  } else {
+    error = fmt::format("line {}, column {}: unknown statement or bad value '{}'", line_number, column_of(line, keyword), keyword);
+    return false;
+  }
+  return true;
+}
+
+bool parse_path_spec(std::string_view text, PathSpec &spec, std::string &error) {
+  size_t line_number = 0;
+
+  while (!text.empty()) {
+    ++line_number;
+    size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text = end == std::string_view::npos? std::string_view() : text.substr(end + 1);
+
+    if (!parse_path_statement(line, line_number, spec, error)) return false;
+  }
+
+  if (spec.segments.empty()) {
+    error = "no path segments";
+    return false;
+  }
+
+  return true;
+}
+
+bool load_path_file(const std::filesystem::path &file, PathSpec &spec, std::string &error) {
+  std::ifstream in(file, std::ios::binary);
+  if (!in) {
+    error = "could not open file";
+    return false;
+  }
+
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+
+  spec.name = file.stem().u8string();
+  return parse_path_spec(buffer.str(), spec, error);
+}
+
+void write_trajectory_csv(std::ostream &out, const TrajectoryTable &table) {
+  out << "t,x,y,vx,vy,kappa,heading,omega\n";
+
+  fmt::memory_buffer line;
+  for (const TrajectorySample &s : table.samples) {
+    line.clear();
+    fmt::format_to(std::back_inserter(line), "{:.4f},{:.5f},{:.5f},{:.5f},{:.5f},{:.5f},{:.5f},{:.5f}\n",
+      s.time, s.position.x, s.position.y, s.velocity.x, s.velocity.y, s.kappa, s.heading, s.omega);
+    out.write(line.data(), line.size());
+  }
+}
+}
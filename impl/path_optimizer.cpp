@@ -0,0 +1,222 @@
+/*
+* frc-pathgen/impl/path_optimizer.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "path_optimizer.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace frc_pathgen {
+
+// handles closer than this to parallel (sin of the angle) count as a smooth joint
+static const float SMOOTH_TOLERANCE = 0.02f;
+
+static Vec2 normalized(Vec2 v, Vec2 fallback) {
+  float len = v.length();
+  return len > 1e-6f? v / len : fallback;
+}
+
+static float profiled_time(const TrajectoryConfig &config, const std::vector<BezierPath> &chain) {
+  std::vector<const Path *> segments;
+  segments.reserve(chain.size());
+  for (const BezierPath &segment : chain) segments.push_back(&segment);
+
+  Trajectory trajectory(config);
+  trajectory.set_segments(segments);
+  return trajectory.duration();
+}
+
+PathOptimizer::PathOptimizer(PathOptimizerConfig config, unsigned int threads) : config(config), pool(threads) {
+}
+
+// layout: start handle (2), then per joint either the incoming handle vector and the
+// outgoing handle length (3, smooth) or both handle points (4), then the end handle (2)
+void PathOptimizer::extract(const std::vector<BezierPath> &chain, std::vector<float> &x) const {
+  x.clear();
+  auto push = [&](Vec2 v) { x.push_back(v.x); x.push_back(v.y); };
+
+  push(chain.front().get_control_point(1));
+  for (size_t j = 0; j + 1 < chain.size(); ++j) {
+    Vec2 joint = chain[j].get_control_point(3);
+    if (this->smooth[j]) {
+      push(joint - chain[j].get_control_point(2));
+      x.push_back((chain[j+1].get_control_point(1) - joint).length());
+    } else {
+      push(chain[j].get_control_point(2));
+      push(chain[j+1].get_control_point(1));
+    }
+  }
+  push(chain.back().get_control_point(2));
+}
+
+void PathOptimizer::apply(const float *x, std::vector<BezierPath> &chain) const {
+  auto pop = [&]() { Vec2 v = { x[0], x[1] }; x += 2; return v; };
+
+  chain.front().set_control_point(1, pop());
+  for (size_t j = 0; j + 1 < chain.size(); ++j) {
+    Vec2 joint = this->base[j].get_control_point(3);
+    if (this->smooth[j]) {
+      Vec2 in = pop();
+      float out = fabsf(*x++);
+      // a collapsed incoming handle keeps the direction the joint started with
+      Vec2 direction = normalized(in, normalized(joint - this->base[j].get_control_point(2), Vec2 { 1,0 }));
+      chain[j].set_control_point(2, joint - in);
+      chain[j+1].set_control_point(1, joint + direction * out);
+    } else {
+      chain[j].set_control_point(2, pop());
+      chain[j+1].set_control_point(1, pop());
+    }
+  }
+  chain.back().set_control_point(2, pop());
+}
+
+float PathOptimizer::evaluate(const float *x, std::vector<BezierPath> &scratch, bool *clear) const {
+  this->apply(x, scratch);
+  float cost = profiled_time(this->config.trajectory, scratch);
+
+  if (!this->obstacles.empty()) {
+    int samples = std::max(this->config.obstacle_samples, 2);
+    float t[256];
+    Vec2 p[256];
+    samples = std::min(samples, 256);
+    for (int i = 0; i < samples; ++i) t[i] = (float)i / (float)(samples - 1);
+
+    // linear in depth, so grazing an obstacle pushes back as hard as cutting through it
+    float intrusion = 0.0f;
+    for (const BezierPath &segment : scratch) {
+      segment.sample_positions(t, p, samples);
+      for (int i = 0; i < samples; ++i) {
+        for (const Obstacle &o : this->obstacles) {
+          float depth = o.radius + this->config.robot_radius - (p[i] - o.center).length();
+          if (depth > 0.0f) intrusion += depth;
+        }
+      }
+    }
+    cost += this->config.obstacle_weight * intrusion / samples;
+    if (clear) *clear = intrusion == 0.0f;
+  }
+
+  return std::isfinite(cost)? cost : INFINITY;
+}
+
+PathOptimizerResult PathOptimizer::optimize(const std::vector<BezierPath *> &chain, bool apply_unclear) {
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point start = Clock::now();
+  auto elapsed = [&]() { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+  PathOptimizerResult result;
+  if (chain.empty()) return result;
+
+  this->base.clear();
+  for (BezierPath *segment : chain) this->base.push_back(*segment);
+
+  this->smooth.assign(chain.size() - 1, false);
+  for (size_t j = 0; j + 1 < chain.size(); ++j) {
+    Vec2 joint = this->base[j].get_control_point(3);
+    if ((this->base[j+1].get_control_point(0) - joint).length() > 1e-4f) {
+      spdlog::warn("Path optimizer: segment {} doesn't start where segment {} ends", j + 1, j);
+    }
+    Vec2 in = joint - this->base[j].get_control_point(2);
+    Vec2 out = this->base[j+1].get_control_point(1) - joint;
+    float scale = in.length() * out.length();
+    this->smooth[j] = scale > 1e-8f && Vec2::dot(in, out) > 0.0f && fabsf(Vec2::cross(in, out)) < SMOOTH_TOLERANCE * scale;
+  }
+
+  std::vector<float> x;
+  this->extract(this->base, x);
+  size_t n = x.size();
+
+  std::vector<BezierPath> scratch = this->base;
+  float cost = this->evaluate(x.data(), scratch);
+  result.initial_time = profiled_time(this->config.trajectory, this->base);
+  ++result.evaluations;
+
+  // one row of variables and one scratch chain per job, reused across iterations
+  size_t lanes = std::max<size_t>(8, this->pool.size());
+  size_t jobs = std::max(2 * n, lanes);
+  std::vector<float> candidates(jobs * n);
+  std::vector<float> costs(jobs);
+  std::vector<std::vector<BezierPath>> scratches(jobs, this->base);
+  std::vector<float> gradient(n), direction(n);
+
+  auto run = [&](size_t count) {
+    for (size_t k = 0; k < count; ++k) {
+      this->pool.submit([&, k] { costs[k] = this->evaluate(&candidates[k * n], scratches[k]); });
+    }
+    this->pool.wait_idle();
+    result.evaluations += (int)count;
+  };
+
+  float step = this->config.initial_step;
+  float h = this->config.difference_step;
+  while (result.iterations < this->config.max_iterations && elapsed() < this->config.time_budget) {
+    ++result.iterations;
+
+    // central differences, every variable is in metres so one step size fits all
+    for (size_t i = 0; i < n; ++i) {
+      std::copy(x.begin(), x.end(), &candidates[(2 * i) * n]);
+      std::copy(x.begin(), x.end(), &candidates[(2 * i + 1) * n]);
+      candidates[(2 * i) * n + i] += h;
+      candidates[(2 * i + 1) * n + i] -= h;
+    }
+    run(2 * n);
+
+    float norm = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+      float g = (costs[2 * i] - costs[2 * i + 1]) / (2.0f * h);
+      gradient[i] = std::isfinite(g)? g : 0.0f;
+      norm += gradient[i] * gradient[i];
+    }
+    norm = sqrtf(norm);
+    if (norm < 1e-6f) {
+      result.converged = true;
+      break;
+    }
+    for (size_t i = 0; i < n; ++i) direction[i] = -gradient[i] / norm;
+
+    // line search, one lane per step size from twice the last good one down by halves
+    for (size_t k = 0; k < lanes; ++k) {
+      float s = 2.0f * step * ldexpf(1.0f, -(int)k);
+      for (size_t i = 0; i < n; ++i) candidates[k * n + i] = x[i] + s * direction[i];
+    }
+    run(lanes);
+
+    size_t best = std::min_element(costs.begin(), costs.begin() + lanes) - costs.begin();
+    if (costs[best] < cost - 1e-5f) {
+      cost = costs[best];
+      std::copy(&candidates[best * n], &candidates[best * n] + n, x.begin());
+      step = 2.0f * step * ldexpf(1.0f, -(int)best);
+    } else {
+      // nothing along the gradient helps, look closer next time
+      step *= ldexpf(1.0f, -(int)lanes);
+      h = std::max(h * 0.5f, 1e-4f);
+    }
+
+    if (step < this->config.min_step) {
+      result.converged = true;
+      break;
+    }
+  }
+
+  this->evaluate(x.data(), scratch, &result.clear);
+  result.final_time = profiled_time(this->config.trajectory, scratch);
+  result.applied = result.clear || apply_unclear;
+  if (result.applied) {
+    for (size_t k = 0; k < chain.size(); ++k) {
+      for (int i = 1; i <= 2; ++i) chain[k]->set_control_point(i, scratch[k].get_control_point(i));
+    }
+  }
+
+  result.seconds = elapsed();
+  spdlog::info("Path optimizer: {:.3f}s -> {:.3f}s in {} iterations, {} evaluations, {:.0f} ms{}{}",
+    result.initial_time, result.final_time, result.iterations, result.evaluations, result.seconds * 1e3,
+    result.converged? "" : " (budget ran out)", result.clear? "" : result.applied? ", still inside an obstacle" : ", inside an obstacle, not applied");
+  return result;
+}
+}
@@ -0,0 +1,271 @@
+/*
+* frc-pathgen/impl/path_preview.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "path_preview.hpp"
+#include "robot.hpp"
+#include "trajectory_cache.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace frc_pathgen {
+
+// coarse, only the keyframes come out of the profile
+static const float PREVIEW_DT = 0.05f;
+static const int SAMPLES_PER_SEGMENT = 32;
+static const float MARGIN = 2.0f; // px around the field
+
+namespace {
+struct Color {
+  uint8_t r, g, b, a;
+};
+
+// world to preview pixels, the field fit inside the image
+struct Canvas {
+  int width, height;
+  uint8_t *pixels;
+  Vec2 offset;
+  float scale;
+  float top; // world y of the field's top edge
+
+  inline Vec2 to_px(Vec2 p) const {
+    return Vec2 { this->offset.x + p.x * this->scale, this->offset.y + (this->top - p.y) * this->scale };
+  }
+
+  inline void blend(int x, int y, Color c, float coverage) {
+    uint8_t *px = this->pixels + ((size_t)y * this->width + x) * 4;
+    float alpha = coverage * c.a / 255.0f;
+    px[0] = (uint8_t)(px[0] + (c.r - px[0]) * alpha);
+    px[1] = (uint8_t)(px[1] + (c.g - px[1]) * alpha);
+    px[2] = (uint8_t)(px[2] + (c.b - px[2]) * alpha);
+    px[3] = 255;
+  }
+
+  // antialiased by each pixel's distance to the segment, a and b in pixels
+  void line(Vec2 a, Vec2 b, float width, Color c) {
+    float reach = width * 0.5f + 1.0f;
+    int x0 = std::max(0, (int)floorf(fminf(a.x, b.x) - reach)), x1 = std::min(this->width - 1, (int)ceilf(fmaxf(a.x, b.x) + reach));
+    int y0 = std::max(0, (int)floorf(fminf(a.y, b.y) - reach)), y1 = std::min(this->height - 1, (int)ceilf(fmaxf(a.y, b.y) + reach));
+
+    Vec2 ab = b - a;
+    float length2 = Vec2::dot(ab, ab);
+    for (int y = y0; y <= y1; ++y) {
+      for (int x = x0; x <= x1; ++x) {
+        Vec2 p = { x + 0.5f, y + 0.5f };
+        float t = length2 > 1e-12f? std::clamp(Vec2::dot(p - a, ab) / length2, 0.0f, 1.0f) : 0.0f;
+        float coverage = std::clamp(width * 0.5f + 0.5f - (p - (a + ab * t)).length(), 0.0f, 1.0f);
+        if (coverage > 0.0f) this->blend(x, y, c, coverage);
+      }
+    }
+  }
+};
+}
+
+static void draw_footprint(Canvas &canvas, Vec2 position, float heading, Color c) {
+  float half = Robot::wheelbase_m * 0.5f;
+  Vec2 forward = { cosf(heading) * half, sinf(heading) * half };
+  Vec2 left = { -forward.y, forward.x };
+
+  Vec2 corners[4] = {
+    canvas.to_px(position + forward + left), canvas.to_px(position + forward - left),
+    canvas.to_px(position - forward - left), canvas.to_px(position - forward + left),
+  };
+  for (int i = 0; i < 4; ++i) canvas.line(corners[i], corners[(i + 1) % 4], 1.0f, c);
+  canvas.line(canvas.to_px(position), canvas.to_px(position + forward), 1.0f, c);
+}
+
+void rasterize_path_preview(const PathPreviewSource &source, const PathPreviewOptions &options, PathPreviewImage &out) {
+  out.width = options.width;
+  out.height = options.height;
+  out.duration = 0.0f;
+  out.pixels.resize((size_t)out.width * out.height * 4);
+
+  for (size_t i = 0; i < out.pixels.size(); i += 4) {
+    out.pixels[i] = 24; out.pixels[i+1] = 26; out.pixels[i+2] = 30; out.pixels[i+3] = 255;
+  }
+
+  Canvas canvas;
+  canvas.width = out.width;
+  canvas.height = out.height;
+  canvas.pixels = out.pixels.data();
+  canvas.scale = fminf((out.width - 2.0f * MARGIN) / options.field_size.x, (out.height - 2.0f * MARGIN) / options.field_size.y);
+  canvas.top = options.field_origin.y + options.field_size.y;
+  canvas.offset = Vec2 {
+    (out.width - options.field_size.x * canvas.scale) * 0.5f - options.field_origin.x * canvas.scale,
+    (out.height - options.field_size.y * canvas.scale) * 0.5f
+  };
+
+  // field bounds and the center line
+  const Color FIELD = { 110, 110, 120, 255 };
+  Vec2 lo = options.field_origin, hi = options.field_origin + options.field_size;
+  Vec2 field[4] = { canvas.to_px(lo), canvas.to_px({ hi.x, lo.y }), canvas.to_px(hi), canvas.to_px({ lo.x, hi.y }) };
+  for (int i = 0; i < 4; ++i) canvas.line(field[i], field[(i + 1) % 4], 1.0f, FIELD);
+  float mid = (lo.x + hi.x) * 0.5f;
+  canvas.line(canvas.to_px({ mid, lo.y }), canvas.to_px({ mid, hi.y }), 1.0f, Color { 70, 70, 80, 255 });
+
+  if (source.segments.empty()) return;
+
+  const Color PATH = { 255, 220, 80, 255 };
+  float t[SAMPLES_PER_SEGMENT + 1];
+  Vec2 points[SAMPLES_PER_SEGMENT + 1];
+  for (int j = 0; j <= SAMPLES_PER_SEGMENT; ++j) t[j] = (float)j / SAMPLES_PER_SEGMENT;
+
+  for (const Path *segment : source.segments) {
+    segment->sample_positions(t, points, SAMPLES_PER_SEGMENT + 1);
+    Vec2 previous = canvas.to_px(points[0]);
+    for (int j = 1; j <= SAMPLES_PER_SEGMENT; ++j) {
+      Vec2 p = canvas.to_px(points[j]);
+      canvas.line(previous, p, 1.5f, PATH);
+      previous = p;
+    }
+  }
+
+  // the footprints come from the profile, so they bunch up where the robot is slow
+  TrajectoryTable table = generate_trajectory(source.segments, source.config, PREVIEW_DT, source.headings);
+  if (table.samples.empty()) return;
+  out.duration = table.duration();
+
+  int keyframes = std::max(1, options.keyframes);
+  for (int k = 0; k < keyframes; ++k) {
+    float time = keyframes > 1? out.duration * k / (keyframes - 1) : 0.0f;
+    TrajectorySample sample = table.at(time);
+    draw_footprint(canvas, sample.position, sample.heading, k == 0? Color { 120, 230, 120, 255 } : Color { 80, 230, 255, 255 });
+  }
+}
+
+PathPreviews::PathPreviews(PathPreviewOptions options) : options(std::move(options)) {
+  unsigned int threads = this->options.threads;
+  if (threads == 0) threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+  this->wanted.reserve(64);
+  this->queue.reserve(64);
+
+  this->workers.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i) this->workers.emplace_back(&PathPreviews::work, this);
+}
+
+PathPreviews::~PathPreviews() {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopping = true;
+  }
+  this->wake.notify_all();
+  for (std::thread &worker : this->workers) worker.join();
+
+  for (auto &[key, preview] : this->resident) {
+    if (preview.texture) SDL_DestroyTexture(preview.texture);
+  }
+}
+
+void PathPreviews::work() {
+  PathPreviewImage image;
+
+  for (;;) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->wake.wait(lock, [this] { return this->stopping || !this->queue.empty(); });
+      if (this->stopping) return;
+
+      job = std::move(this->queue.back());
+      this->queue.pop_back();
+      this->in_flight.insert(job.key);
+    }
+
+    rasterize_path_preview(job.source, this->options, image);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->finished.push_back(Finished { job.key, std::move(image) });
+    this->in_flight.erase(job.key);
+  }
+}
+
+void PathPreviews::begin_frame(SDL_Renderer *r) {
+  ++this->frame;
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    size_t n = std::min(this->finished.size(), (size_t)this->options.uploads_per_frame);
+    this->arrived.clear();
+    std::move(this->finished.begin(), this->finished.begin() + n, std::back_inserter(this->arrived));
+    this->finished.erase(this->finished.begin(), this->finished.begin() + n);
+  }
+
+  for (Finished &f : this->arrived) {
+    const PathPreviewImage &image = f.image;
+    SDL_Texture *texture = SDL_CreateTexture(r, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, image.width, image.height);
+    if (texture && SDL_UpdateTexture(texture, nullptr, image.pixels.data(), image.width * 4) != 0) {
+      SDL_DestroyTexture(texture);
+      texture = nullptr;
+    }
+    if (!texture) spdlog::warn("Could not upload path preview: {}", SDL_GetError());
+    this->resident[f.key] = Preview { texture, image.duration, this->frame };
+  }
+  this->arrived.clear();
+}
+
+uint64_t PathPreviews::key_of(const PathPreviewSource &source) {
+  return trajectory_key(source.segments, source.config, PREVIEW_DT, source.headings);
+}
+
+SDL_Texture *PathPreviews::get(const PathPreviewSource &source, float *duration) {
+  return this->get(key_of(source), source, duration);
+}
+
+SDL_Texture *PathPreviews::get(uint64_t key, const PathPreviewSource &source, float *duration) {
+  auto it = this->resident.find(key);
+  if (it != this->resident.end()) {
+    it->second.last_shown = this->frame;
+    if (duration) *duration = it->second.duration;
+    return it->second.texture;
+  }
+
+  for (const Job &job : this->wanted) if (job.key == key) return nullptr;
+  this->wanted.push_back(Job { key, source });
+  return nullptr;
+}
+
+void PathPreviews::end_frame() {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // already on the way
+    this->wanted.erase(std::remove_if(this->wanted.begin(), this->wanted.end(), [this](const Job &job) {
+      if (this->in_flight.count(job.key)) return true;
+      for (const Finished &f : this->finished) if (f.key == job.key) return true;
+      return false;
+    }), this->wanted.end());
+
+    // replaces whatever was queued, previews that scrolled away are not worth drawing.
+    // reversed, so the workers (taking from the back) go top to bottom
+    this->queue.assign(std::make_move_iterator(this->wanted.rbegin()), std::make_move_iterator(this->wanted.rend()));
+  }
+  if (!this->wanted.empty()) this->wake.notify_all();
+  this->wanted.clear();
+
+  this->evict();
+}
+
+void PathPreviews::evict() {
+  if (this->resident.size() <= this->options.max_textures) return;
+
+  // never the ones shown this frame, the budget only bounds what is off screen
+  this->eviction_order.clear();
+  for (auto &[key, preview] : this->resident) {
+    if (preview.last_shown != this->frame) this->eviction_order.emplace_back(preview.last_shown, key);
+  }
+  std::sort(this->eviction_order.begin(), this->eviction_order.end());
+
+  size_t excess = this->resident.size() - this->options.max_textures;
+  for (size_t i = 0; i < excess && i < this->eviction_order.size(); ++i) {
+    auto it = this->resident.find(this->eviction_order[i].second);
+    if (it->second.texture) SDL_DestroyTexture(it->second.texture);
+    this->resident.erase(it);
+  }
+}
+}
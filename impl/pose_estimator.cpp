@@ -0,0 +1,227 @@
+/*
+* frc-pathgen/impl/pose_estimator.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "pose_estimator.hpp"
+#include <cmath>
+
+namespace frc_pathgen {
+
+using Mat3 = std::array<std::array<float, 3>, 3>;
+
+static float wrap_angle(float a) {
+  return atan2f(sinf(a), cosf(a));
+}
+
+static Mat3 multiply(const Mat3 &a, const Mat3 &b) {
+  Mat3 out = {};
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      for (int k = 0; k < 3; ++k) out[i][j] += a[i][k] * b[k][j];
+  return out;
+}
+
+static Mat3 transpose(const Mat3 &a) {
+  Mat3 out;
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j) out[i][j] = a[j][i];
+  return out;
+}
+
+// false if singular
+static bool invert(const Mat3 &m, Mat3 &out) {
+  float c00 = m[1][1]*m[2][2] - m[1][2]*m[2][1];
+  float c01 = m[1][2]*m[2][0] - m[1][0]*m[2][2];
+  float c02 = m[1][0]*m[2][1] - m[1][1]*m[2][0];
+  float det = m[0][0]*c00 + m[0][1]*c01 + m[0][2]*c02;
+  if (fabsf(det) < 1e-12f) return false;
+
+  float inv = 1.0f / det;
+  out[0][0] = c00 * inv;
+  out[1][0] = c01 * inv;
+  out[2][0] = c02 * inv;
+  out[0][1] = (m[0][2]*m[2][1] - m[0][1]*m[2][2]) * inv;
+  out[1][1] = (m[0][0]*m[2][2] - m[0][2]*m[2][0]) * inv;
+  out[2][1] = (m[0][1]*m[2][0] - m[0][0]*m[2][1]) * inv;
+  out[0][2] = (m[0][1]*m[1][2] - m[0][2]*m[1][1]) * inv;
+  out[1][2] = (m[0][2]*m[1][0] - m[0][0]*m[1][2]) * inv;
+  out[2][2] = (m[0][0]*m[1][1] - m[0][1]*m[1][0]) * inv;
+  return true;
+}
+
+PoseEstimator::PoseEstimator(PoseEstimatorConfig config) : config(config) {
+  this->reset(Pose {}, 0.0f);
+}
+
+void PoseEstimator::reset(const Pose &pose, float time, float position_stddev, float heading_stddev) {
+  Step &step = this->steps[0];
+  step.time = time;
+  step.body_displacement = { 0,0 };
+  step.heading_change = 0.0f;
+  step.vision_count = 0;
+  step.pose = pose;
+  step.covariance = {};
+  step.covariance[0][0] = step.covariance[1][1] = position_stddev * position_stddev;
+  step.covariance[2][2] = heading_stddev * heading_stddev;
+
+  this->first = 0;
+  this->count = 1;
+}
+
+void PoseEstimator::propagate(const Step &from, Step &to) const {
+  Vec2 d = to.body_displacement;
+  // rotate by the heading halfway through the step, closer to the arc actually driven
+  float heading = from.pose.heading + 0.5f * to.heading_change;
+  float c = cosf(heading), s = sinf(heading);
+
+  to.pose.position = from.pose.position + Vec2 { c*d.x - s*d.y, s*d.x + c*d.y };
+  to.pose.heading = wrap_angle(from.pose.heading + to.heading_change);
+
+  // jacobian of the motion model with respect to the previous state
+  Mat3 F = {{
+    { 1.0f, 0.0f, -(s*d.x + c*d.y) },
+    { 0.0f, 1.0f,   c*d.x - s*d.y  },
+    { 0.0f, 0.0f,   1.0f           },
+  }};
+
+  float distance = d.length();
+  float dt = fmaxf(0.0f, to.time - from.time);
+  float q_xy = this->config.odometry_stddev * distance;
+  float q_heading = this->config.gyro_stddev * fabsf(to.heading_change);
+
+  to.covariance = multiply(multiply(F, from.covariance), transpose(F));
+  to.covariance[0][0] += q_xy * q_xy + 1e-8f;
+  to.covariance[1][1] += q_xy * q_xy + 1e-8f;
+  to.covariance[2][2] += q_heading * q_heading + this->config.gyro_drift * this->config.gyro_drift * dt;
+}
+
+void PoseEstimator::predict(float time, Vec2 body_displacement, float heading_change) {
+  const Step &previous = this->latest();
+
+  // full ring, the oldest step falls off
+  size_t index;
+  if (this->count == HISTORY) {
+    index = this->first;
+    this->first = (this->first + 1) % HISTORY;
+  } else {
+    index = (this->first + this->count) % HISTORY;
+    ++this->count;
+  }
+
+  Step &step = this->steps[index];
+  step.time = time;
+  step.body_displacement = body_displacement;
+  step.heading_change = heading_change;
+  step.vision_count = 0;
+  this->propagate(previous, step);
+}
+
+bool PoseEstimator::correct(Step &step, const Vision &vision, float gate) const {
+  const Mat3 &P = step.covariance;
+
+  // H is the identity, so S = P + R and K = P S^-1
+  Mat3 S = P;
+  S[0][0] += vision.position_variance;
+  S[1][1] += vision.position_variance;
+  S[2][2] += vision.heading_variance;
+
+  Mat3 S_inv;
+  if (!invert(S, S_inv)) return false;
+
+  float y[3] = {
+    vision.pose.position.x - step.pose.position.x,
+    vision.pose.position.y - step.pose.position.y,
+    wrap_angle(vision.pose.heading - step.pose.heading)
+  };
+
+  float mahalanobis = 0.0f;
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j) mahalanobis += y[i] * S_inv[i][j] * y[j];
+  if (mahalanobis > gate) return false;
+
+  Mat3 K = multiply(P, S_inv);
+  float correction[3] = {};
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j) correction[i] += K[i][j] * y[j];
+
+  step.pose.position += Vec2 { correction[0], correction[1] };
+  step.pose.heading = wrap_angle(step.pose.heading + correction[2]);
+
+  // P = (I - K) P
+  Mat3 I_K = {};
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j) I_K[i][j] = (i == j? 1.0f : 0.0f) - K[i][j];
+  step.covariance = multiply(I_K, P);
+  return true;
+}
+
+bool PoseEstimator::add_vision(float time, const Pose &measured, float position_stddev, float heading_stddev) {
+  this->last_replay = 0;
+
+  // last step at or before the capture time
+  if (time < this->at(0).time) {
+    ++this->dropped;
+    return false;
+  }
+  size_t lo = 0, hi = this->count;
+  while (hi - lo > 1) {
+    size_t mid = (lo + hi) / 2;
+    if (this->at(mid).time <= time) lo = mid;
+    else hi = mid;
+  }
+
+  Step &step = this->at(lo);
+  if (step.vision_count == VISION_PER_STEP) {
+    ++this->dropped;
+    return false;
+  }
+
+  Vision vision = { measured, position_stddev * position_stddev, heading_stddev * heading_stddev };
+  bool trusted = this->consecutive_rejects >= this->config.max_consecutive_rejects;
+  if (!this->correct(step, vision, trusted? INFINITY : this->config.outlier_gate)) {
+    ++this->rejected;
+    ++this->consecutive_rejects;
+    return false;
+  }
+  this->consecutive_rejects = 0;
+  step.vision[step.vision_count++] = vision;
+
+  // the corrected step changes everything after it, and the vision fused there has to be
+  // applied again on top. it passed the gate once, so it isn't gated twice
+  for (size_t i = lo + 1; i < this->count; ++i) {
+    Step &next = this->at(i);
+    this->propagate(this->at(i - 1), next);
+    for (size_t v = 0; v < next.vision_count; ++v) this->correct(next, next.vision[v], INFINITY);
+  }
+  this->last_replay = this->count - 1 - lo;
+
+  ++this->fused;
+  return true;
+}
+
+Vec2 PoseEstimator::get_velocity() const {
+  if (this->count < 2) return Vec2 { 0,0 };
+  const Step &step = this->latest();
+  float dt = step.time - this->at(this->count - 2).time;
+  if (dt <= 0.0f) return Vec2 { 0,0 };
+
+  // the same midpoint heading propagate() drives along
+  float heading = step.pose.heading - 0.5f * step.heading_change;
+  float c = cosf(heading), s = sinf(heading);
+  Vec2 d = step.body_displacement;
+  return Vec2 { c*d.x - s*d.y, s*d.x + c*d.y } / dt;
+}
+
+float PoseEstimator::get_position_stddev() const {
+  const Mat3 &P = this->latest().covariance;
+  return sqrtf(fmaxf(0.0f, 0.5f * (P[0][0] + P[1][1])));
+}
+
+float PoseEstimator::get_heading_stddev() const {
+  return sqrtf(fmaxf(0.0f, this->latest().covariance[2][2]));
+}
+}
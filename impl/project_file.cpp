@@ -0,0 +1,534 @@
+/*
+* frc-pathgen/impl/project_file.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "project_file.hpp"
+#include "trajectory_cache.hpp"
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+namespace frc_pathgen {
+
+static const char *const KIND_NAMES[] = { "robot", "path", "routine" };
+
+// walks the text a line at a time without copying any of it
+struct LineReader {
+  std::string_view text;
+  size_t offset = 0;
+  size_t line_number = 0; // of the line next() returned last
+
+  bool next(std::string_view &line, size_t &line_offset) {
+    if (this->offset >= this->text.size()) return false;
+    size_t end = this->text.find('\n', this->offset);
+    if (end == std::string_view::npos) end = this->text.size();
+
+    line_offset = this->offset;
+    line = this->text.substr(this->offset, end - this->offset);
+    this->offset = end + 1;
+    ++this->line_number;
+    return true;
+  }
+};
+
+static bool parse_size(std::string_view token, size_t &out) {
+  auto result = std::from_chars(token.data(), token.data() + token.size(), out);
+  return result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+static bool block_kind(std::string_view keyword, ProjectBlock::Kind &kind) {
+  for (int k = 0; k < 3; ++k) {
+    if (keyword == KIND_NAMES[k]) {
+      kind = (ProjectBlock::Kind)k;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ProjectFile::open(const std::filesystem::path &file, std::string &error) {
+  std::ifstream in(file, std::ios::binary);
+  if (!in) {
+    this->clear();
+    error = "could not open file";
+    return false;
+  }
+
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  return this->open_text(buffer.str(), error);
+}
+
+bool ProjectFile::open_text(std::string text, std::string &error) {
+  this->text = std::move(text);
+  if (this->read_blocks(error)) return true;
+
+  // a project that failed part of the way lists nothing, its rows couldn't be loaded
+  this->clear();
+  return false;
+}
+
+void ProjectFile::clear() {
+  this->indexed = false;
+  this->has_robot = false;
+  this->robot = PathSpec();
+  this->paths.clear();
+  this->routines.clear();
+  this->loaded_paths.clear();
+  this->loaded_profiles.clear();
+  this->loaded_routines.clear();
+}
+
+bool ProjectFile::read_blocks(std::string &error) {
+  this->clear();
+  if (!this->read_header(error)) return false;
+
+  size_t body = 0, body_line = 0;
+  this->indexed = this->read_index(body, body_line);
+  this->body_offset = body;
+  this->body_line = body_line;
+  if (!this->indexed) {
+    this->paths.clear();
+    this->routines.clear();
+    this->has_robot = false;
+    if (!this->scan_blocks(body, body_line, error)) return false;
+  }
+
+  this->loaded_paths.resize(this->paths.size());
+  this->loaded_profiles.resize(this->paths.size());
+  this->loaded_routines.resize(this->routines.size());
+
+  if (!this->check_names(error)) return false;
+  return this->load_robot(error);
+}
+
+bool ProjectFile::read_header(std::string &error) {
+  LineReader reader { this->text };
+  std::string_view line;
+  size_t offset;
+  while (reader.next(line, offset)) {
+    std::string_view tokens[4];
+    size_t count = split_statement(line, tokens);
+    if (count == 0) continue;
+
+    size_t version = 0;
+    if (count != 3 || tokens[0] != "frc-pathgen" || tokens[1] != "project") {
+      error = fmt::format("line {}, column {}: expected 'frc-pathgen project {}'", reader.line_number,
+        column_of(line, tokens[0]), FORMAT_VERSION);
+      return false;
+    }
+    if (!parse_size(tokens[2], version) || version == 0 || version > (size_t)FORMAT_VERSION) {
+      error = fmt::format("line {}, column {}: unsupported project version '{}'", reader.line_number,
+        column_of(line, tokens[2]), tokens[2]);
+      return false;
+    }
+
+    this->body_offset = reader.offset;
+    this->body_line = reader.line_number + 1;
+    return true;
+  }
+
+  error = "line 1, column 1: empty project";
+  return false;
+}
+
+// whether a stretch between blocks is only blank lines and comments
+static bool only_blank(std::string_view text) {
+  LineReader reader { text };
+  std::string_view line;
+  size_t offset;
+  while (reader.next(line, offset)) {
+    std::string_view tokens[1];
+    if (split_statement(line, tokens) > 0) return false;
+  }
+  return true;
+}
+
+// true if there was an index and it still matches the file: every entry's header and `end`
+// where it says, nothing but blank lines between them, and whatever comes after the last
+// one (added since indexing) scans. body/body_line are where the blocks start either way
+bool ProjectFile::read_index(size_t &body, size_t &body_line) {
+  LineReader reader { this->text, this->body_offset, this->body_line - 1 };
+  body = this->body_offset;
+  body_line = this->body_line;
+
+  std::string_view line;
+  size_t offset;
+  std::string_view tokens[6];
+  size_t count = 0;
+  while (reader.next(line, offset)) {
+    count = split_statement(line, tokens);
+    if (count > 0) break;
+  }
+  size_t entries = 0;
+  if (count != 2 || tokens[0] != "index" || !parse_size(tokens[1], entries)) return false;
+
+  std::vector<ProjectBlock> blocks;
+  for (size_t i = 0; i < entries; ++i) {
+    if (!reader.next(line, offset) || split_statement(line, tokens) != 5) return false;
+
+    ProjectBlock block;
+    if (!block_kind(tokens[0], block.kind) || !parse_size(tokens[2], block.offset) || !parse_size(tokens[3], block.line) ||
+      !parse_size(tokens[4], block.length)) return false;
+    block.name = block.kind == ProjectBlock::ROBOT? std::string_view() : tokens[1];
+    blocks.push_back(block);
+  }
+  if (!reader.next(line, offset) || split_statement(line, tokens) != 1 || tokens[0] != "end") return false;
+
+  std::string_view text = this->text;
+  size_t cursor = reader.offset, cursor_line = reader.line_number + 1;
+  for (ProjectBlock &block : blocks) {
+    // in file order with only blank lines before it, or the file changed since indexing
+    if (block.offset < cursor || block.offset >= text.size() || block.length > text.size() - block.offset) return false;
+    if (!only_blank(text.substr(cursor, block.offset - cursor))) return false;
+
+    // the header at that offset has to be this block's
+    std::string_view at = text.substr(block.offset, block.length);
+    std::string_view header[3];
+    size_t header_count = split_statement(at.substr(0, at.find('\n')), header);
+    if (header_count == 0 || header[0] != KIND_NAMES[block.kind]) return false;
+    if (block.kind == ProjectBlock::ROBOT? header_count != 1 : (header_count != 2 || header[1] != block.name)) return false;
+    // names point into the block header, the index is gone once the file is re-indexed
+    if (block.kind != ProjectBlock::ROBOT) block.name = header[1];
+
+    // and its last line has to be its `end`
+    if (block.offset + block.length < text.size() && (at.empty() || at.back() != '\n')) return false;
+    if (!at.empty() && at.back() == '\n') at.remove_suffix(1);
+    size_t last = at.rfind('\n');
+    std::string_view footer[2];
+    if (last == std::string_view::npos || split_statement(at.substr(last + 1), footer) != 1 || footer[0] != "end") return false;
+
+    if (block.kind == ProjectBlock::ROBOT) {
+      if (this->has_robot) return false;
+      this->robot_block = block;
+      this->has_robot = true;
+    } else {
+      (block.kind == ProjectBlock::PATH? this->paths : this->routines).push_back(block);
+    }
+    cursor = block.offset + block.length;
+    cursor_line = block.line + (size_t)std::count(at.begin(), at.end(), '\n') + 1;
+  }
+
+  // blocks appended after indexing
+  std::string ignored;
+  if (!this->scan_blocks(cursor, cursor_line, ignored)) return false;
+
+  body = reader.offset;
+  body_line = reader.line_number + 1;
+  return true;
+}
+
+// only looks at the first word of each line, nothing inside the blocks is parsed
+bool ProjectFile::scan_blocks(size_t body, size_t body_line, std::string &error) {
+  LineReader reader { this->text, body, body_line - 1 };
+  std::string_view line;
+  size_t offset;
+
+  bool inside = false, in_index = false;
+  ProjectBlock open_block = {};
+  ProjectBlock *open_target = nullptr; // where open_block was stored, to fill in its length
+  while (reader.next(line, offset)) {
+    std::string_view tokens[3];
+    size_t count = split_statement(line, tokens);
+    if (count == 0) continue;
+
+    if (inside) {
+      if (tokens[0] != "end") continue;
+      inside = false;
+      if (open_target) open_target->length = std::min(reader.offset, this->text.size()) - open_target->offset;
+      // a stale index doesn't count as part of the body, indexed_text() replaces it
+      if (in_index) {
+        in_index = false;
+        this->body_offset = reader.offset;
+        this->body_line = reader.line_number + 1;
+      }
+      continue;
+    }
+
+    // an index that no longer matches the file, only allowed before the first block
+    if (tokens[0] == "index" && this->paths.empty() && this->routines.empty() && !this->has_robot) {
+      size_t entries = 0;
+      if (count == 2 && parse_size(tokens[1], entries)) {
+        inside = in_index = true;
+        open_block = ProjectBlock { ProjectBlock::ROBOT, "index", offset, reader.line_number, 0 };
+        open_target = nullptr;
+        continue;
+      }
+    }
+
+    ProjectBlock block;
+    if (!block_kind(tokens[0], block.kind)) {
+      error = fmt::format("line {}, column {}: expected path, routine or robot, got '{}'", reader.line_number,
+        column_of(line, tokens[0]), tokens[0]);
+      return false;
+    }
+    size_t expected = block.kind == ProjectBlock::ROBOT? 1 : 2;
+    if (count != expected) {
+      error = fmt::format("line {}, column {}: '{}' takes {}", reader.line_number, column_of(line, tokens[0]),
+        tokens[0], expected == 1? "no name" : "one name");
+      return false;
+    }
+
+    block.name = count > 1? tokens[1] : std::string_view();
+    block.offset = offset;
+    block.line = reader.line_number;
+    block.length = 0;
+    if (block.kind == ProjectBlock::ROBOT) {
+      if (this->has_robot) {
+        error = fmt::format("line {}, column 1: second robot block, the first is on line {}", block.line, this->robot_block.line);
+        return false;
+      }
+      this->robot_block = block;
+      this->has_robot = true;
+      open_target = &this->robot_block;
+    } else {
+      std::vector<ProjectBlock> &blocks = block.kind == ProjectBlock::PATH? this->paths : this->routines;
+      blocks.push_back(block);
+      open_target = &blocks.back();
+    }
+    inside = true;
+    open_block = block;
+  }
+
+  if (inside) {
+    error = fmt::format("line {}, column 1: '{}' is missing its end", open_block.line, in_index? "index" : KIND_NAMES[open_block.kind]);
+    return false;
+  }
+  return true;
+}
+
+// routines find their paths by name, so a second path (or routine) of the same name would be unreachable
+bool ProjectFile::check_names(std::string &error) const {
+  for (const std::vector<ProjectBlock> *blocks : { &this->paths, &this->routines }) {
+    std::vector<const ProjectBlock *> sorted;
+    sorted.reserve(blocks->size());
+    for (const ProjectBlock &block : *blocks) sorted.push_back(&block);
+    std::sort(sorted.begin(), sorted.end(), [](const ProjectBlock *a, const ProjectBlock *b) {
+      return a->name != b->name? a->name < b->name : a->line < b->line;
+    });
+
+    for (size_t i = 1; i < sorted.size(); ++i) {
+      if (sorted[i]->name != sorted[i-1]->name) continue;
+      error = fmt::format("line {}, column 1: second {} named '{}', the first is on line {}", sorted[i]->line,
+        KIND_NAMES[sorted[i]->kind], sorted[i]->name, sorted[i-1]->line);
+      return false;
+    }
+  }
+  return true;
+}
+
+template<typename F>
+bool ProjectFile::for_each_statement(const ProjectBlock &block, std::string &error, F &&statement) const {
+  LineReader reader { this->text, block.offset, block.line - 1 };
+  std::string_view line;
+  size_t offset;
+  reader.next(line, offset); // the block header
+
+  while (reader.next(line, offset)) {
+    std::string_view tokens[1];
+    if (split_statement(line, tokens) > 0 && tokens[0] == "end") return true;
+    if (!statement(line, reader.line_number)) return false;
+  }
+
+  error = fmt::format("line {}, column 1: '{}' is missing its end", block.line, KIND_NAMES[block.kind]);
+  return false;
+}
+
+bool ProjectFile::load_robot(std::string &error) {
+  if (!this->has_robot) return true;
+
+  return this->for_each_statement(this->robot_block, error, [&](std::string_view line, size_t line_number) {
+    if (!parse_path_statement(line, line_number, this->robot, error)) return false;
+    if (!this->robot.segments.empty()) {
+      error = fmt::format("line {}, column 1: the robot block only takes settings, paths go in path blocks", line_number);
+      return false;
+    }
+    return true;
+  });
+}
+
+int ProjectFile::find_path(std::string_view name) const {
+  for (size_t i = 0; i < this->paths.size(); ++i) {
+    if (this->paths[i].name == name) return (int)i;
+  }
+  return -1;
+}
+
+const PathSpec *ProjectFile::load_path(size_t index, std::string &error) {
+  if (this->loaded_paths[index]) return this->loaded_paths[index].get();
+
+  const ProjectBlock &block = this->paths[index];
+  auto spec = std::make_unique<PathSpec>();
+  spec->name = std::string(block.name);
+  spec->config = this->robot.config;
+  spec->dt = this->robot.dt;
+
+  bool ok = this->for_each_statement(block, error, [&](std::string_view line, size_t line_number) {
+    return parse_path_statement(line, line_number, *spec, error);
+  });
+  if (!ok) return nullptr;
+  if (spec->segments.empty()) {
+    error = fmt::format("line {}, column 1: path '{}' has no segments", block.line, block.name);
+    return nullptr;
+  }
+
+  this->loaded_paths[index] = std::move(spec);
+  return this->loaded_paths[index].get();
+}
+
+const TrajectoryTable *ProjectFile::load_profile(size_t index, std::string &error, TrajectoryCache *cache) {
+  if (this->loaded_profiles[index]) return this->loaded_profiles[index].get();
+
+  const PathSpec *spec = this->load_path(index, error);
+  if (!spec) return nullptr;
+
+  std::vector<const Path *> segments = spec->segment_pointers();
+  this->loaded_profiles[index] = std::make_unique<TrajectoryTable>(cache?
+    cache->get_or_generate(segments, spec->config, spec->dt, spec->headings) :
+    generate_trajectory(segments, spec->config, spec->dt, spec->headings));
+  return this->loaded_profiles[index].get();
+}
+
+const ProjectRoutine *ProjectFile::load_routine(size_t index, std::string &error) {
+  if (this->loaded_routines[index]) return this->loaded_routines[index].get();
+
+  auto routine = std::make_unique<ProjectRoutine>();
+  bool ok = this->for_each_statement(this->routines[index], error, [&](std::string_view line, size_t line_number) {
+    std::string_view tokens[4];
+    size_t count = split_statement(line, tokens);
+    if (count == 0) return true;
+
+    std::string_view keyword = tokens[0];
+    float value = 0.0f;
+    if (keyword == "path" && (count == 2 || count == 3)) {
+      int path = this->find_path(tokens[1]);
+      if (path < 0) {
+        error = fmt::format("line {}, column {}: no path named '{}'", line_number, column_of(line, tokens[1]), tokens[1]);
+        return false;
+      }
+      Joint joint = Joint::STOP;
+      if (count == 3) {
+        if (tokens[2] == "pass") joint = Joint::PASS_THROUGH;
+        else if (tokens[2] != "stop") {
+          error = fmt::format("line {}, column {}: joint is 'stop' or 'pass', not '{}'", line_number, column_of(line, tokens[2]), tokens[2]);
+          return false;
+        }
+      }
+      routine->steps.push_back({ RoutineStep::PATH, (size_t)path, joint, 0.0f });
+    } else if (keyword == "wait" && count == 2) {
+      if (!parse_float(tokens[1], value) || value < 0.0f) {
+        error = fmt::format("line {}, column {}: '{}' is not a wait in seconds", line_number, column_of(line, tokens[1]), tokens[1]);
+        return false;
+      }
+      routine->steps.push_back({ RoutineStep::WAIT, 0, Joint::STOP, value });
+    } else if (keyword == "marker" && (count == 2 || count == 3)) {
+      if (count == 3 && !parse_float(tokens[2], value)) {
+        error = fmt::format("line {}, column {}: '{}' is not a number", line_number, column_of(line, tokens[2]), tokens[2]);
+        return false;
+      }
+      size_t step = routine->steps.empty()? 0 : routine->steps.size() - 1;
+      routine->markers.push_back(RoutineMarker { std::string(tokens[1]), step, value });
+    } else {
+      error = fmt::format("line {}, column {}: expected 'path <name> [stop|pass]', 'wait <s>' or 'marker <name> [s]'",
+        line_number, column_of(line, keyword));
+      return false;
+    }
+    return true;
+  });
+  if (!ok) return nullptr;
+
+  this->loaded_routines[index] = std::move(routine);
+  return this->loaded_routines[index].get();
+}
+
+bool ProjectFile::build_routine(size_t index, Routine &out, std::string &error) {
+  const ProjectRoutine *routine = this->load_routine(index, error);
+  if (!routine) return false;
+
+  size_t marker = 0;
+  auto add_markers = [&](size_t step) {
+    for (; marker < routine->markers.size() && routine->markers[marker].step == step; ++marker) {
+      out.add_marker(routine->markers[marker].name, routine->markers[marker].offset);
+    }
+  };
+
+  for (size_t s = 0; s < routine->steps.size(); ++s) {
+    const ProjectRoutine::Step &step = routine->steps[s];
+    if (step.kind == RoutineStep::WAIT) {
+      out.add_wait(step.wait_seconds);
+      add_markers(s);
+      continue;
+    }
+
+    const PathSpec *spec = this->load_path(step.path, error);
+    if (!spec) return false;
+    // markers go on the first segment, so their offsets count from the start of the whole path
+    for (size_t k = 0; k < spec->segments.size(); ++k) {
+      out.add_path(*spec->segments[k], k + 1 < spec->segments.size()? Joint::PASS_THROUGH : step.joint);
+      spec->add_segment_headings(out, k);
+      if (k == 0) add_markers(s);
+    }
+  }
+  add_markers(0);
+  return true;
+}
+
+std::string ProjectFile::indexed_text() const {
+  std::vector<ProjectBlock> blocks = this->paths;
+  blocks.insert(blocks.end(), this->routines.begin(), this->routines.end());
+  if (this->has_robot) blocks.push_back(this->robot_block);
+  std::sort(blocks.begin(), blocks.end(), [](const ProjectBlock &a, const ProjectBlock &b) { return a.offset < b.offset; });
+
+  // offsets and lines are fixed width, so the prefix is the same length whatever they are
+  auto index_line = [](const ProjectBlock &b, size_t offset, size_t line) {
+    return fmt::format("  {} {} {:010} {:08} {:010}\n", KIND_NAMES[b.kind], b.name.empty()? "-" : b.name, offset, line, b.length);
+  };
+  std::string prefix = fmt::format("frc-pathgen project {}\nindex {}\n", FORMAT_VERSION, blocks.size());
+  size_t prefix_size = prefix.size() + 4; // "end\n"
+  for (const ProjectBlock &b : blocks) prefix_size += index_line(b, 0, 0).size();
+  size_t prefix_lines = 3 + blocks.size();
+
+  for (const ProjectBlock &b : blocks) {
+    prefix += index_line(b, prefix_size + b.offset - this->body_offset, prefix_lines + 1 + b.line - this->body_line);
+  }
+  prefix += "end\n";
+  prefix.append(this->text, this->body_offset, std::string::npos);
+  return prefix;
+}
+
+int run_index(const std::filesystem::path &file) {
+  ProjectFile project;
+  std::string error;
+  if (!project.open(file, error)) {
+    fmt::print(stderr, "{}: {}\n", file.u8string(), error);
+    return 1;
+  }
+
+  std::filesystem::path temp = file;
+  temp += ".tmp";
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    out << project.indexed_text();
+    if (!out) {
+      fmt::print(stderr, "could not write {}\n", temp.u8string());
+      return 1;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(temp, file, ec);
+  if (ec) {
+    fmt::print(stderr, "could not replace {}: {}\n", file.u8string(), ec.message());
+    return 1;
+  }
+
+  fmt::print("{}: indexed {} paths and {} routines\n", file.u8string(), project.get_paths().size(), project.get_routines().size());
+  return 0;
+}
+}
@@ -69,6 +69,12 @@ void Robot::draw(SDL_Renderer *renderer, const Viewport &viewport) {
 
   ImGui::Begin("Robot controls");
   ImGui::Checkbox("Enable Keyboard", &this->enable_keyboard_control);
+  if (ImGui::CollapsingHeader("History")) {
+    const TelemetryChannel *speeds[] = { &this->speed_setpoint_history, &this->speed_history };
+    const TelemetryChannel *outputs[] = { &this->drive_output_history, &this->turn_output_history };
+    this->speed_plot.draw("speed (m/s)", speeds, 2);
+    this->output_plot.draw("motor out", outputs, 2);
+  }
   ImGui::End();
 }
 
@@ -98,6 +104,11 @@ void Robot::tick(float dt) {
 
   this->velocity *= expf(-.1 * dt);
   this->angular_velocity *= expf(-.1 * dt);
+
+  this->speed_setpoint_history.push(this->velocity_setpoint.length());
+  this->speed_history.push(this->velocity.length());
+  this->drive_output_history.push(this->velocity_percent.length());
+  this->turn_output_history.push(this->angular_velocity_percent);
 }
 
 void Robot::apply_voltages(Vec2 xy, float r, float dt) {
@@ -0,0 +1,583 @@
+/*
+* frc-pathgen/impl/robot_log.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "robot_log.hpp"
+#include <spdlog/spdlog.h>
+#include <spdlog/fmt/fmt.h>
+#include <imgui.h>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace frc_pathgen {
+
+// how far the scan gets between letting go of the pages behind it
+static const size_t RELEASE_STRIDE = 8ull << 20;
+// channels per array entry, the rest of a long array is ignored
+static const size_t MAX_ARRAY_CHANNELS = 16;
+
+MappedFile::~MappedFile() {
+  if (this->bytes) munmap((void *)this->bytes, this->length);
+}
+
+bool MappedFile::open(const std::filesystem::path &file, std::string &error) {
+  if (this->bytes) munmap((void *)this->bytes, this->length);
+  this->bytes = nullptr;
+  this->length = 0;
+  this->released = 0;
+
+  int fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = fmt::format("could not open {}: {}", file.u8string(), strerror(errno));
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    error = fmt::format("could not stat {}: {}", file.u8string(), strerror(errno));
+    ::close(fd);
+    return false;
+  }
+  if (st.st_size == 0) {
+    ::close(fd);
+    return true;
+  }
+
+  void *mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    error = fmt::format("could not map {}: {}", file.u8string(), strerror(errno));
+    return false;
+  }
+
+  madvise(mapped, (size_t)st.st_size, MADV_SEQUENTIAL);
+  this->bytes = static_cast<const uint8_t *>(mapped);
+  this->length = (size_t)st.st_size;
+  return true;
+}
+
+void MappedFile::release_before(size_t offset) {
+  static const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  size_t end = std::min(offset, this->length) / page * page;
+  if (end <= this->released) return;
+
+  madvise((void *)(this->bytes + this->released), end - this->released, MADV_DONTNEED);
+  this->released = end;
+}
+
+size_t LogColumn::lower_bound(float t) const {
+  return (size_t)(std::lower_bound(this->time.begin(), this->time.end(), t) - this->time.begin());
+}
+
+float LogColumn::at(float t) const {
+  if (this->time.empty()) return 0.0f;
+
+  size_t i = this->lower_bound(t);
+  if (i == 0) return this->value.front();
+  if (i == this->time.size()) return this->value.back();
+
+  float t0 = this->time[i-1], t1 = this->time[i];
+  float f = t1 > t0? (t - t0) / (t1 - t0) : 1.0f;
+  return this->value[i-1] + (this->value[i] - this->value[i-1]) * f;
+}
+
+// Turns a stream of (channel, time, value) into decimated columns, or with no RobotLog to
+// fill just collects the channel names.
+class LogImporter {
+public:
+  LogImporter(RobotLog *out, const RobotLogOptions *options) : out(out), options(options) {}
+
+  // column for a channel, -1 if it isn't wanted
+  int channel(const std::string &name) {
+    if (!this->seen.emplace(name, -1).second) return this->seen[name];
+    this->names.push_back(name);
+    if (!this->out) return -1;
+
+    const std::vector<std::string> &wanted = this->options->channels;
+    if (!wanted.empty() && std::find(wanted.begin(), wanted.end(), name) == wanted.end()) return -1;
+
+    int column = (int)this->out->columns.size();
+    this->out->columns.push_back(LogColumn { name, {}, {} });
+    this->pending.push_back(Pending {});
+    this->seen[name] = column;
+    return column;
+  }
+
+  inline bool listing() const { return this->out == nullptr; }
+
+  void push(int column, float time, float value) {
+    ++this->out->raw_samples;
+    this->out->end_time = std::max(this->out->end_time, time);
+
+    float dt = this->options->decimate_dt;
+    if (dt <= 0.0f) {
+      this->emit(column, time, value);
+      return;
+    }
+
+    // each interval keeps its lowest and highest sample, so spikes survive
+    Pending &p = this->pending[column];
+    int64_t bucket = (int64_t)floorf(time / dt);
+    if (p.any && bucket != p.bucket) this->flush(column);
+
+    if (!p.any) {
+      p = Pending { true, bucket, time, value, time, value };
+    } else if (value < p.lo_value) {
+      p.lo_time = time;
+      p.lo_value = value;
+    } else if (value > p.hi_value) {
+      p.hi_time = time;
+      p.hi_value = value;
+    }
+  }
+
+  void finish() {
+    if (this->listing()) return;
+    for (size_t c = 0; c < this->pending.size(); ++c) this->flush((int)c);
+
+    // interleaved writers can land a sample out of order now and then
+    for (LogColumn &column : this->out->columns) {
+      if (std::is_sorted(column.time.begin(), column.time.end())) continue;
+
+      std::vector<size_t> order(column.time.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return column.time[a] < column.time[b]; });
+      LogColumn sorted = { column.name, {}, {} };
+      sorted.time.reserve(order.size());
+      sorted.value.reserve(order.size());
+      for (size_t i : order) {
+        sorted.time.push_back(column.time[i]);
+        sorted.value.push_back(column.value[i]);
+      }
+      column = std::move(sorted);
+    }
+  }
+
+  std::vector<std::string> names;
+private:
+  struct Pending {
+    bool any = false;
+    int64_t bucket = 0;
+    float lo_time = 0.0f, lo_value = 0.0f;
+    float hi_time = 0.0f, hi_value = 0.0f;
+  };
+
+  void emit(int column, float time, float value) {
+    LogColumn &c = this->out->columns[column];
+    c.time.push_back(time);
+    c.value.push_back(value);
+  }
+
+  void flush(int column) {
+    Pending &p = this->pending[column];
+    if (!p.any) return;
+
+    bool lo_first = p.lo_time <= p.hi_time;
+    this->emit(column, lo_first? p.lo_time : p.hi_time, lo_first? p.lo_value : p.hi_value);
+    if (p.lo_time != p.hi_time) this->emit(column, lo_first? p.hi_time : p.lo_time, lo_first? p.hi_value : p.lo_value);
+    p.any = false;
+  }
+
+  RobotLog *out;
+  const RobotLogOptions *options;
+  std::vector<Pending> pending;
+  std::unordered_map<std::string, int> seen;
+};
+
+static inline uint64_t read_le(const uint8_t *p, size_t bytes) {
+  uint64_t v = 0;
+  for (size_t i = 0; i < bytes; ++i) v |= (uint64_t)p[i] << (8 * i);
+  return v;
+}
+
+static inline uint32_t read_u32(const uint8_t *p) {
+  return (uint32_t)read_le(p, 4);
+}
+
+namespace {
+struct LogEntry {
+  enum Element { DOUBLE, FLOAT, INT64, BOOLEAN } element;
+  bool array = false;
+  std::string name;
+  std::vector<int> columns; // per value in a record, arrays grow as longer records show up
+};
+
+const char *const POSE2D[] = { ".x", ".y", ".rotation" };
+// like a Pose2d's, so it's picked as the heading the same way
+const char *const ROTATION2D[] = { ".rotation" };
+const char *const TRANSLATION2D[] = { ".x", ".y" };
+const char *const CHASSIS_SPEEDS[] = { ".vx", ".vy", ".omega" };
+}
+
+// false for types that aren't numbers
+static bool describe_entry(std::string_view type, LogEntry &entry, LogImporter &importer) {
+  auto fixed = [&](LogEntry::Element element, const char *const *suffixes, size_t count) {
+    entry.element = element;
+    for (size_t i = 0; i < count; ++i) entry.columns.push_back(importer.channel(entry.name + suffixes[i]));
+    return true;
+  };
+  static const char *const SCALAR[] = { "" };
+
+  if (type == "double") return fixed(LogEntry::DOUBLE, SCALAR, 1);
+  if (type == "float") return fixed(LogEntry::FLOAT, SCALAR, 1);
+  if (type == "int64") return fixed(LogEntry::INT64, SCALAR, 1);
+  if (type == "boolean") return fixed(LogEntry::BOOLEAN, SCALAR, 1);
+  if (type == "struct:Rotation2d") return fixed(LogEntry::DOUBLE, ROTATION2D, 1);
+  if (type == "struct:Pose2d") return fixed(LogEntry::DOUBLE, POSE2D, 3);
+  if (type == "struct:Translation2d") return fixed(LogEntry::DOUBLE, TRANSLATION2D, 2);
+  if (type == "struct:ChassisSpeeds") return fixed(LogEntry::DOUBLE, CHASSIS_SPEEDS, 3);
+
+  entry.array = true;
+  if (type == "double[]") entry.element = LogEntry::DOUBLE;
+  else if (type == "float[]") entry.element = LogEntry::FLOAT;
+  else if (type == "int64[]") entry.element = LogEntry::INT64;
+  else if (type == "boolean[]") entry.element = LogEntry::BOOLEAN;
+  else return false;
+  return true;
+}
+
+static inline size_t element_size(LogEntry::Element element) {
+  return element == LogEntry::BOOLEAN? 1 : element == LogEntry::FLOAT? 4 : 8;
+}
+
+// little endian like the format, which is every machine this runs on
+static inline float read_element(const uint8_t *p, LogEntry::Element element) {
+  switch (element) {
+    case LogEntry::DOUBLE: { double v; memcpy(&v, p, 8); return (float)v; }
+    case LogEntry::FLOAT: { float v; memcpy(&v, p, 4); return v; }
+    case LogEntry::INT64: { int64_t v; memcpy(&v, p, 8); return (float)v; }
+    case LogEntry::BOOLEAN: return p[0]? 1.0f : 0.0f;
+  }
+  return 0.0f;
+}
+
+// WPILib DataLog: "WPILOG", u16 version, u32 extra header length and the extra header, then
+// records of a bitfield byte (entry id, payload size and timestamp widths), those three
+// little endian, and the payload. Entry 0 is control records: start, finish, set metadata.
+static bool read_wpilog(MappedFile &file, LogImporter &importer, std::string &error) {
+  const uint8_t *d = file.data();
+  size_t n = file.size();
+
+  if (n < 12 || memcmp(d, "WPILOG", 6) != 0) {
+    error = "not a wpilog file";
+    return false;
+  }
+  uint32_t version = (uint32_t)read_le(d + 6, 2);
+  if (version < 0x0100) {
+    error = fmt::format("wpilog version {}.{} is too old", version >> 8, version & 0xff);
+    return false;
+  }
+
+  std::unordered_map<uint32_t, LogEntry> entries;
+  LogEntry *last = nullptr;
+  uint32_t last_id = 0;
+  bool have_start = false;
+  uint64_t start_time = 0;
+
+  size_t pos = 12 + (size_t)read_u32(d + 8);
+  size_t next_release = RELEASE_STRIDE;
+  while (pos < n) {
+    uint8_t bits = d[pos];
+    size_t id_bytes = (bits & 0x3) + 1, size_bytes = ((bits >> 2) & 0x3) + 1, time_bytes = ((bits >> 4) & 0x7) + 1;
+    size_t header = 1 + id_bytes + size_bytes + time_bytes;
+    if (pos + header > n) break;
+
+    uint32_t id = (uint32_t)read_le(d + pos + 1, id_bytes);
+    size_t size = (size_t)read_le(d + pos + 1 + id_bytes, size_bytes);
+    uint64_t timestamp = read_le(d + pos + 1 + id_bytes + size_bytes, time_bytes);
+    const uint8_t *payload = d + pos + header;
+    if (pos + header + size > n) break;
+    pos += header + size;
+
+    if (!have_start) {
+      start_time = timestamp;
+      have_start = true;
+    }
+
+    if (pos >= next_release) {
+      file.release_before(pos);
+      next_release = pos + RELEASE_STRIDE;
+    }
+
+    if (id == 0) {
+      // start: u32 entry, then name, type and metadata as u32 length + utf-8
+      if (size < 5 || payload[0] != 0) continue;
+      uint32_t entry_id = read_u32(payload + 1);
+      size_t at = 5;
+      std::string_view fields[2];
+      bool ok = true;
+      for (int f = 0; f < 2 && ok; ++f) {
+        if (at + 4 > size) { ok = false; break; }
+        uint32_t length = read_u32(payload + at);
+        if (at + 4 + length > size) { ok = false; break; }
+        fields[f] = std::string_view(reinterpret_cast<const char *>(payload + at + 4), length);
+        at += 4 + length;
+      }
+      if (!ok) continue;
+
+      LogEntry entry;
+      entry.name = std::string(fields[0]);
+      if (describe_entry(fields[1], entry, importer)) entries[entry_id] = std::move(entry);
+      else entries.erase(entry_id);
+      last = nullptr;
+      continue;
+    }
+
+    if (!last || id != last_id) {
+      auto it = entries.find(id);
+      if (it == entries.end()) continue;
+      last = &it->second;
+      last_id = id;
+    }
+    LogEntry &entry = *last;
+
+    size_t stride = element_size(entry.element);
+    size_t values = size / stride;
+    if (entry.array) {
+      // names only exist once a record says how long the array is
+      values = std::min(values, MAX_ARRAY_CHANNELS);
+      while (entry.columns.size() < values) {
+        entry.columns.push_back(importer.channel(fmt::format("{}[{}]", entry.name, entry.columns.size())));
+      }
+    }
+    if (importer.listing()) continue;
+
+    float time = timestamp > start_time? (float)((double)(timestamp - start_time) * 1e-6) : 0.0f;
+    values = std::min(values, entry.columns.size());
+    for (size_t v = 0; v < values; ++v) {
+      if (entry.columns[v] >= 0) importer.push(entry.columns[v], time, read_element(payload + v * stride, entry.element));
+    }
+  }
+
+  if (pos < n) spdlog::warn("Robot log ends in a partial record, {} bytes ignored", n - pos);
+  return true;
+}
+
+static inline std::string_view trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '"')) s.remove_prefix(1);
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r' || s.back() == '"')) s.remove_suffix(1);
+  return s;
+}
+
+// calls field(index, text) for every comma separated field of a line
+template<typename F>
+static void split_csv(std::string_view line, F &&field) {
+  size_t index = 0;
+  for (;;) {
+    size_t comma = line.find(',');
+    field(index++, trim(line.substr(0, comma)));
+    if (comma == std::string_view::npos) return;
+    line.remove_prefix(comma + 1);
+  }
+}
+
+static bool read_csv(MappedFile &file, LogImporter &importer, std::string &error) {
+  std::string_view text(reinterpret_cast<const char *>(file.data()), file.size());
+
+  size_t newline = text.find('\n');
+  std::string_view header = text.substr(0, newline);
+  text.remove_prefix(newline == std::string_view::npos? text.size() : newline + 1);
+
+  std::vector<std::string> names;
+  size_t time_field = SIZE_MAX;
+  split_csv(header, [&](size_t i, std::string_view name) {
+    names.emplace_back(name);
+    if (time_field == SIZE_MAX && (name == "t" || name == "time" || name == "timestamp")) time_field = i;
+  });
+  if (names.size() < 2) {
+    error = "expected a csv header row with a time column and at least one channel";
+    return false;
+  }
+  if (time_field == SIZE_MAX) time_field = 0;
+
+  std::vector<int> columns(names.size(), -1);
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (i != time_field) columns[i] = importer.channel(names[i]);
+  }
+  if (importer.listing()) return true;
+
+  std::vector<float> row(names.size());
+  std::vector<bool> present(names.size());
+  // timestamps can be since the epoch, far past what a float holds to the millisecond
+  double timestamp = 0.0, start_time = 0.0;
+  bool have_start = false;
+
+  size_t base = file.size() - text.size();
+  size_t next_release = RELEASE_STRIDE;
+  while (!text.empty()) {
+    newline = text.find('\n');
+    std::string_view line = text.substr(0, newline);
+    text.remove_prefix(newline == std::string_view::npos? text.size() : newline + 1);
+
+    std::fill(present.begin(), present.end(), false);
+    split_csv(line, [&](size_t i, std::string_view field) {
+      if (i >= row.size() || field.empty()) return;
+      auto result = i == time_field?
+        std::from_chars(field.data(), field.data() + field.size(), timestamp) :
+        std::from_chars(field.data(), field.data() + field.size(), row[i]);
+      present[i] = result.ec == std::errc();
+    });
+    if (!present[time_field]) continue;
+
+    if (!have_start) {
+      start_time = timestamp;
+      have_start = true;
+    }
+    float time = (float)(timestamp - start_time);
+    for (size_t i = 0; i < row.size(); ++i) {
+      if (present[i] && columns[i] >= 0) importer.push(columns[i], time, row[i]);
+    }
+
+    size_t pos = file.size() - text.size();
+    if (pos - base >= next_release) {
+      file.release_before(pos);
+      next_release = pos - base + RELEASE_STRIDE;
+    }
+  }
+  return true;
+}
+
+static bool is_wpilog(const MappedFile &file) {
+  return file.size() >= 6 && memcmp(file.data(), "WPILOG", 6) == 0;
+}
+
+bool RobotLog::open(const std::filesystem::path &file, const RobotLogOptions &options, std::string &error) {
+  this->columns.clear();
+  this->end_time = 0.0f;
+  this->raw_samples = 0;
+
+  MappedFile mapped;
+  if (!mapped.open(file, error)) return false;
+
+  LogImporter importer(this, &options);
+  bool ok = is_wpilog(mapped)? read_wpilog(mapped, importer, error) : read_csv(mapped, importer, error);
+  importer.finish();
+  return ok;
+}
+
+bool RobotLog::list_channels(const std::filesystem::path &file, std::vector<std::string> &names, std::string &error) {
+  MappedFile mapped;
+  if (!mapped.open(file, error)) return false;
+
+  LogImporter importer(nullptr, nullptr);
+  bool ok = is_wpilog(mapped)? read_wpilog(mapped, importer, error) : read_csv(mapped, importer, error);
+  names = std::move(importer.names);
+  return ok;
+}
+
+const LogColumn *RobotLog::find(std::string_view name) const {
+  for (const LogColumn &column : this->columns) {
+    if (column.name == name) return &column;
+  }
+  return nullptr;
+}
+
+void RobotLogPlot::draw(const char *label, const LogColumn *const *columns, const uint32_t *colors, size_t count,
+  float t0, float t1, float cursor, float height) {
+  ImVec2 origin = ImGui::GetCursorScreenPos();
+  float width = std::max(ImGui::GetContentRegionAvail().x, 16.0f);
+  ImGui::Dummy(ImVec2(width, height));
+  if (!ImGui::IsItemVisible() || count == 0 || t1 <= t0) return;
+
+  ImDrawList *draw_list = ImGui::GetWindowDrawList();
+  ImVec2 corner = ImVec2(origin.x + width, origin.y + height);
+  draw_list->AddRectFilled(origin, corner, IM_COL32(20, 20, 24, 255));
+  draw_list->AddRect(origin, corner, IM_COL32(70, 70, 80, 255));
+
+  size_t pixels = std::min((size_t)width, MAX_COLUMNS);
+  float column_time = (t1 - t0) / pixels;
+  float column_width = width / pixels;
+  float top = origin.y + 2.0f, bottom = corner.y - 2.0f;
+
+  // bounds first, over what's in the window
+  float lo = 0.0f, hi = 0.0f;
+  bool any = false;
+  for (size_t i = 0; i < count; ++i) {
+    const LogColumn &c = *columns[i];
+    for (size_t k = c.lower_bound(t0); k < c.time.size() && c.time[k] <= t1; ++k) {
+      lo = any? std::min(lo, c.value[k]) : c.value[k];
+      hi = any? std::max(hi, c.value[k]) : c.value[k];
+      any = true;
+    }
+  }
+  if (!any) {
+    draw_list->AddText(ImVec2(origin.x + 4, origin.y + 2), IM_COL32(200, 200, 200, 255), label);
+    return;
+  }
+  if (hi - lo < 1e-6f) {
+    lo -= 0.5f;
+    hi += 0.5f;
+  }
+  float scale = (bottom - top) / (hi - lo);
+  auto to_y = [&](float v) { return bottom - (v - lo) * scale; };
+
+  draw_list->PushClipRect(origin, corner, true);
+  for (size_t i = 0; i < count; ++i) {
+    const LogColumn &c = *columns[i];
+    if (c.time.empty()) continue;
+
+    // one walk through the samples in the window, a pixel without any takes the line between its neighbours
+    size_t k = c.lower_bound(t0);
+    for (size_t p = 0; p < pixels; ++p) {
+      float a = t0 + p * column_time, b = a + column_time;
+      this->valid[p] = false;
+      if (b < c.time.front() || a > c.time.back()) continue;
+
+      this->valid[p] = true;
+      this->lo[p] = this->hi[p] = c.at(0.5f * (a + b));
+      for (; k < c.time.size() && c.time[k] < b; ++k) {
+        this->lo[p] = std::min(this->lo[p], c.value[k]);
+        this->hi[p] = std::max(this->hi[p], c.value[k]);
+      }
+    }
+
+    for (size_t p = 0; p < pixels; ++p) {
+      if (!this->valid[p]) continue;
+      float x = origin.x + (p + 0.5f) * column_width;
+      float span_lo = this->lo[p], span_hi = this->hi[p];
+      if (p > 0 && this->valid[p-1]) {
+        span_lo = std::min(span_lo, this->hi[p-1]);
+        span_hi = std::max(span_hi, this->lo[p-1]);
+      }
+      draw_list->AddLine(ImVec2(x, to_y(span_hi)), ImVec2(x, to_y(span_lo) + 1.0f), colors[i]);
+    }
+  }
+
+  if (cursor >= t0 && cursor <= t1) {
+    float x = origin.x + (cursor - t0) / (t1 - t0) * width;
+    draw_list->AddLine(ImVec2(x, origin.y), ImVec2(x, corner.y), IM_COL32(255, 255, 255, 160));
+  }
+  draw_list->PopClipRect();
+
+  // label, legend and scale
+  char text[64];
+  float x = origin.x + 4.0f;
+  draw_list->AddText(ImVec2(x, origin.y + 2.0f), IM_COL32(200, 200, 200, 255), label);
+  x += ImGui::CalcTextSize(label).x + 12.0f;
+  for (size_t i = 0; i < count; ++i) {
+    draw_list->AddText(ImVec2(x, origin.y + 2.0f), colors[i], columns[i]->name.c_str());
+    x += ImGui::CalcTextSize(columns[i]->name.c_str()).x + 12.0f;
+  }
+
+  snprintf(text, sizeof(text), "%.3g", hi);
+  draw_list->AddText(ImVec2(corner.x - ImGui::CalcTextSize(text).x - 4.0f, origin.y + 2.0f), IM_COL32(140, 140, 140, 255), text);
+  snprintf(text, sizeof(text), "%.3g", lo);
+  draw_list->AddText(ImVec2(corner.x - ImGui::CalcTextSize(text).x - 4.0f, bottom - ImGui::GetFontSize()), IM_COL32(140, 140, 140, 255), text);
+  snprintf(text, sizeof(text), "%.1f - %.1f s", t0, t1);
+  draw_list->AddText(ImVec2(origin.x + 4.0f, bottom - ImGui::GetFontSize()), IM_COL32(140, 140, 140, 255), text);
+}
+}
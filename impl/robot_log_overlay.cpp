@@ -0,0 +1,277 @@
+/*
+* frc-pathgen/impl/robot_log_overlay.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "robot_log_overlay.hpp"
+#include "robot.hpp"
+#include <spdlog/spdlog.h>
+#include <imgui.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace frc_pathgen {
+
+// the trail is drawn every frame, a whole match at full rate would be far too many lines
+static const size_t MAX_TRAIL_POINTS = 4000;
+static const size_t MAX_PLOTTED = 4; // channels in the channel plot
+// the plots walk every sample in their window each frame, a match is about as much as stays cheap
+static const float MAX_WINDOW = 180.0f;
+// simulated pose samples kept, a few minutes of frames
+static const size_t MAX_SIM_SAMPLES = 1 << 14;
+
+static bool ends_with(std::string_view s, std::string_view suffix) {
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static bool is_pose_channel(std::string_view name) {
+  return ends_with(name, ".x") || ends_with(name, ".y") || ends_with(name, ".rotation") ||
+    name == "x" || name == "y" || name == "heading";
+}
+
+RobotLogOverlay::RobotLogOverlay(std::filesystem::path default_file) {
+  snprintf(this->file, sizeof(this->file), "%s", default_file.u8string().c_str());
+}
+
+void RobotLogOverlay::list() {
+  std::shared_ptr<Job> job = std::make_shared<Job>();
+  job->kind = Job::LIST;
+  this->error.clear();
+  this->job = job;
+
+  std::filesystem::path file = this->file;
+  this->pool.submit([job, file] {
+    job->ok = RobotLog::list_channels(file, job->channels, job->error);
+    job->done.store(true, std::memory_order_release);
+  });
+}
+
+void RobotLogOverlay::import() {
+  RobotLogOptions options;
+  options.decimate_dt = this->decimate_dt;
+  for (size_t i = 0; i < this->channels.size(); ++i) {
+    if (this->selected[i]) options.channels.push_back(this->channels[i]);
+  }
+  if (options.channels.empty()) {
+    this->error = "no channels selected";
+    return;
+  }
+
+  std::shared_ptr<Job> job = std::make_shared<Job>();
+  job->kind = Job::IMPORT;
+  this->error.clear();
+  this->job = job;
+
+  std::filesystem::path file = this->file;
+  this->pool.submit([job, file, options = std::move(options)] {
+    auto begin = std::chrono::steady_clock::now();
+    job->ok = job->log.open(file, options, job->error);
+    job->ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    job->done.store(true, std::memory_order_release);
+  });
+}
+
+void RobotLogOverlay::poll() {
+  if (!this->job || !this->job->done.load(std::memory_order_acquire)) return;
+  std::shared_ptr<Job> job = std::move(this->job);
+  this->error = std::move(job->error);
+  if (!job->ok) return;
+
+  if (job->kind == Job::LIST) {
+    this->channels = std::move(job->channels);
+    // the pose is what the overlay is for, everything else is opt in
+    this->selected.assign(this->channels.size(), 0);
+    for (size_t i = 0; i < this->channels.size(); ++i) this->selected[i] = is_pose_channel(this->channels[i]);
+    return;
+  }
+
+  this->log = std::move(job->log);
+  this->import_ms = job->ms;
+  size_t kept = 0;
+  for (const LogColumn &column : this->log.get_columns()) kept += column.time.size();
+  spdlog::info("Robot log: {} channels, {:.1f} s, {} samples kept of {} in {:.0f} ms", this->log.get_columns().size(),
+    this->log.duration(), kept, this->log.samples_read(), this->import_ms);
+
+  this->guess_pose_channels();
+  for (LogColumn &column : this->sim) {
+    column.time.clear();
+    column.value.clear();
+  }
+}
+
+void RobotLogOverlay::record_sim(float sim_time, Vec2 sim_position, float sim_heading) {
+  // a restarted run or a moved offset would put samples out of order
+  if (sim_time < this->last_sim_time || this->offset != this->sim_offset || this->sim[0].time.size() >= MAX_SIM_SAMPLES) {
+    for (LogColumn &column : this->sim) {
+      column.time.clear();
+      column.value.clear();
+    }
+  }
+  this->last_sim_time = sim_time;
+  this->sim_offset = this->offset;
+
+  const float values[3] = { sim_position.x, sim_position.y, sim_heading };
+  for (int i = 0; i < 3; ++i) {
+    this->sim[i].time.push_back(sim_time + this->offset);
+    this->sim[i].value.push_back(values[i]);
+  }
+}
+
+void RobotLogOverlay::guess_pose_channels() {
+  const std::vector<LogColumn> &columns = this->log.get_columns();
+  this->x_column = this->y_column = this->heading_column = -1;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    std::string_view name = columns[i].name;
+    if (this->x_column < 0 && (ends_with(name, ".x") || name == "x")) this->x_column = (int)i;
+    if (this->y_column < 0 && (ends_with(name, ".y") || name == "y")) this->y_column = (int)i;
+    if (this->heading_column < 0 && (ends_with(name, ".rotation") || name == "heading")) this->heading_column = (int)i;
+  }
+  this->build_trail();
+}
+
+void RobotLogOverlay::build_trail() {
+  const std::vector<LogColumn> &columns = this->log.get_columns();
+  this->trail.clear();
+  if (this->x_column < 0 || this->y_column < 0) return;
+
+  // x and y may be sampled apart, so the trail goes along x's times
+  const LogColumn &x = columns[this->x_column], &y = columns[this->y_column];
+  size_t stride = std::max<size_t>(1, (x.time.size() + MAX_TRAIL_POINTS - 1) / MAX_TRAIL_POINTS);
+  this->trail.reserve(x.time.size() / stride + 1);
+  for (size_t i = 0; i < x.time.size(); i += stride) this->trail.push_back(Vec2 { x.value[i], y.at(x.time[i]) });
+  this->trail_px.resize(this->trail.size());
+}
+
+static void column_combo(const char *label, int &column, const std::vector<LogColumn> &columns) {
+  if (!ImGui::BeginCombo(label, column >= 0? columns[column].name.c_str() : "none")) return;
+  if (ImGui::Selectable("none", column < 0)) column = -1;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    ImGui::PushID((int)i);
+    if (ImGui::Selectable(columns[i].name.c_str(), column == (int)i)) column = (int)i;
+    ImGui::PopID();
+  }
+  ImGui::EndCombo();
+}
+
+void RobotLogOverlay::draw_window() {
+  ImGui::Begin("Robot log");
+  ImGui::InputText("File", this->file, sizeof(this->file));
+  ImGui::BeginDisabled(this->job != nullptr);
+  if (ImGui::Button("List channels")) this->list();
+  ImGui::SameLine();
+  ImGui::BeginDisabled(this->channels.empty());
+  if (ImGui::Button("Import")) this->import();
+  ImGui::EndDisabled();
+  ImGui::EndDisabled();
+  ImGui::SliderFloat("Decimate (s)", &this->decimate_dt, 0.0f, 0.05f, "%.3f");
+  if (this->job) ImGui::TextUnformatted(this->job->kind == Job::LIST? "Listing..." : "Importing...");
+  if (!this->error.empty()) ImGui::TextWrapped("%s", this->error.c_str());
+
+  if (!this->channels.empty() && ImGui::CollapsingHeader("Channels")) {
+    ImGui::BeginChild("channels", ImVec2(0, 160), true);
+    for (size_t i = 0; i < this->channels.size(); ++i) {
+      bool on = this->selected[i];
+      if (ImGui::Checkbox(this->channels[i].c_str(), &on)) this->selected[i] = on;
+    }
+    ImGui::EndChild();
+  }
+
+  const std::vector<LogColumn> &columns = this->log.get_columns();
+  if (columns.empty()) {
+    ImGui::End();
+    return;
+  }
+
+  ImGui::Text("%zu channels, %.1f s, imported in %.0f ms", columns.size(), this->log.duration(), this->import_ms);
+  int x = this->x_column, y = this->y_column;
+  column_combo("X", this->x_column, columns);
+  column_combo("Y", this->y_column, columns);
+  column_combo("Heading", this->heading_column, columns);
+  if (x != this->x_column || y != this->y_column) this->build_trail();
+
+  ImGui::Checkbox("Follow sim", &this->follow_sim);
+  if (this->follow_sim) {
+    ImGui::SliderFloat("Offset (s)", &this->offset, -this->log.duration(), this->log.duration(), "%.2f");
+    this->log_time = std::clamp(this->last_sim_time + this->offset, 0.0f, this->log.duration());
+  } else {
+    ImGui::SliderFloat("Time (s)", &this->log_time, 0.0f, this->log.duration(), "%.2f");
+  }
+  ImGui::SliderFloat("Window (s)", &this->window, 1.0f, std::clamp(this->log.duration(), 1.0f, MAX_WINDOW), "%.1f");
+
+  float t0 = std::max(0.0f, this->log_time - this->window * 0.5f), t1 = t0 + this->window;
+
+  // each logged pose channel with the simulated one beside it, dimmer
+  const LogColumn *pose[6];
+  uint32_t pose_colors[6];
+  size_t pose_count = 0;
+  const int pose_columns[3] = { this->x_column, this->y_column, this->heading_column };
+  const uint32_t POSE_COLORS[3] = { IM_COL32(255, 90, 90, 255), IM_COL32(120, 220, 120, 255), IM_COL32(80, 160, 255, 255) };
+  const uint32_t SIM_COLORS[3] = { IM_COL32(255, 90, 90, 110), IM_COL32(120, 220, 120, 110), IM_COL32(80, 160, 255, 110) };
+  for (int i = 0; i < 3; ++i) {
+    if (pose_columns[i] < 0) continue;
+    pose[pose_count] = &columns[pose_columns[i]];
+    pose_colors[pose_count++] = POSE_COLORS[i];
+    pose[pose_count] = &this->sim[i];
+    pose_colors[pose_count++] = SIM_COLORS[i];
+  }
+  this->pose_plot.draw("pose", pose, pose_colors, pose_count, t0, t1, this->log_time);
+
+  // the first few channels that aren't the pose
+  const LogColumn *others[MAX_PLOTTED];
+  const uint32_t OTHER_COLORS[MAX_PLOTTED] = {
+    IM_COL32(80, 255, 255, 255), IM_COL32(255, 255, 80, 255), IM_COL32(180, 130, 255, 255), IM_COL32(255, 150, 60, 255)
+  };
+  size_t other_count = 0;
+  for (size_t i = 0; i < columns.size() && other_count < MAX_PLOTTED; ++i) {
+    if ((int)i == this->x_column || (int)i == this->y_column || (int)i == this->heading_column) continue;
+    others[other_count++] = &columns[i];
+  }
+  if (other_count > 0) this->channel_plot.draw("channels", others, OTHER_COLORS, other_count, t0, t1, this->log_time);
+
+  ImGui::End();
+}
+
+void RobotLogOverlay::draw(SDL_Renderer *renderer, const Viewport &viewport, float sim_time, Vec2 sim_position, float sim_heading) {
+  this->poll();
+  if (!this->log.get_columns().empty()) this->record_sim(sim_time, sim_position, sim_heading);
+  this->draw_window();
+  if (this->trail.size() < 2 || this->x_column < 0 || this->y_column < 0) return;
+
+  for (size_t i = 0; i < this->trail.size(); ++i) {
+    Vec2 p = viewport.world_to_px(this->trail[i]);
+    this->trail_px[i] = SDL_FPoint { p.x, p.y };
+  }
+  SDL_SetRenderDrawColor(renderer, 200, 90, 255, 255);
+  SDL_RenderDrawLinesF(renderer, this->trail_px.data(), (int)this->trail_px.size());
+
+  // where the real robot was at the log time
+  const std::vector<LogColumn> &columns = this->log.get_columns();
+  Vec2 position = { columns[this->x_column].at(this->log_time), columns[this->y_column].at(this->log_time) };
+  float heading = this->heading_column >= 0? columns[this->heading_column].at(this->log_time) : 0.0f;
+
+  float hs = Robot::wheelbase_m / 2.0f;
+  Vec2 f = { cosf(heading), sinf(heading) };
+  Vec2 l = { -f.y, f.x };
+  Vec2 corners[5] = {
+    position + (f + l) * hs,
+    position + (f - l) * hs,
+    position - (f + l) * hs,
+    position - (f - l) * hs,
+    position + (f + l) * hs,
+  };
+  SDL_FPoint points[5];
+  for (int i = 0; i < 5; ++i) {
+    Vec2 p = viewport.world_to_px(corners[i]);
+    points[i] = SDL_FPoint { p.x, p.y };
+  }
+  SDL_RenderDrawLinesF(renderer, points, 5);
+  Vec2 cp = viewport.world_to_px(position);
+  Vec2 hp = viewport.world_to_px(position + f * hs);
+  SDL_RenderDrawLineF(renderer, cp.x, cp.y, hp.x, hp.y);
+}
+}
@@ -0,0 +1,161 @@
+/*
+* frc-pathgen/impl/routine.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "routine.hpp"
+#include "trajectory_cache.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace frc_pathgen {
+
+void Routine::add_path(const Path &path, Joint joint) {
+  RoutineStep step = { RoutineStep::PATH };
+  step.path = &path;
+  step.joint = joint;
+  this->steps.push_back(step);
+}
+
+void Routine::add_wait(float seconds) {
+  RoutineStep step = { RoutineStep::WAIT };
+  step.wait_seconds = fmaxf(0.0f, seconds);
+  this->steps.push_back(step);
+}
+
+void Routine::add_marker(std::string name, float offset) {
+  size_t step = this->steps.empty()? 0 : this->steps.size() - 1;
+  this->markers.push_back(RoutineMarker { std::move(name), step, offset });
+}
+
+void Routine::add_heading(float t, float heading) {
+  size_t step = this->steps.size();
+  while (step > 0 && this->steps[step-1].kind != RoutineStep::PATH) --step;
+  if (step == 0) return;
+  this->headings.push_back(RoutineHeading { step - 1, t, heading });
+}
+
+CompiledRoutine Routine::compile(const TrajectoryConfig &config, float dt, TrajectoryCache *cache) const {
+  CompiledRoutine out;
+  out.table.dt = dt;
+  out.step_start.assign(this->steps.size(), 0.0f);
+
+  // pieces laid back to back on the timeline, either a profiled chain or a hold
+  struct Piece {
+    float start;
+    float duration;
+    TrajectoryTable table;
+    Vec2 hold;
+    float hold_heading;
+  };
+  std::vector<Piece> pieces;
+
+  float time = 0.0f;
+  Vec2 position = { 0,0 };
+  float heading = 0.0f;
+  for (const RoutineStep &step : this->steps) {
+    if (step.kind == RoutineStep::PATH) {
+      position = step.path->sample_position(0.0f);
+      break;
+    }
+  }
+
+  size_t i = 0;
+  while (i < this->steps.size()) {
+    if (this->steps[i].kind == RoutineStep::WAIT) {
+      out.step_start[i] = time;
+      pieces.push_back(Piece { time, this->steps[i].wait_seconds, {}, position, heading });
+      time += this->steps[i].wait_seconds;
+      ++i;
+      continue;
+    }
+
+    // a pass-through joint only means something if another path follows it
+    size_t first = i;
+    std::vector<const Path *> chain;
+    for (;;) {
+      chain.push_back(this->steps[i].path);
+      bool pass = this->steps[i].joint == Joint::PASS_THROUGH &&
+        i + 1 < this->steps.size() && this->steps[i+1].kind == RoutineStep::PATH;
+      ++i;
+      if (!pass) break;
+    }
+
+    // the chain's own waypoints, from wherever the last one left the robot facing
+    std::vector<HeadingWaypoint> chain_headings;
+    bool starts_set = false;
+    for (const RoutineHeading &h : this->headings) {
+      if (h.step < first || h.step >= i) continue;
+      float u = (float)(h.step - first) + std::clamp(h.t, 0.0f, 1.0f);
+      chain_headings.push_back(HeadingWaypoint { u, h.heading });
+      starts_set = starts_set || u <= 0.0f;
+    }
+    // a trajectory starts at heading 0 by itself
+    if (!starts_set && heading != 0.0f) chain_headings.push_back(HeadingWaypoint { 0.0f, heading });
+
+    TrajectoryTable table = cache? cache->get_or_generate(chain, config, dt, chain_headings) : generate_trajectory(chain, config, dt, chain_headings);
+
+    for (size_t k = 0; k < chain.size(); ++k) {
+      out.step_start[first + k] = time + (k < table.segment_start.size()? table.segment_start[k] : 0.0f);
+      out.table.segment_start.push_back(out.step_start[first + k]);
+    }
+
+    float duration = table.duration();
+    if (!table.samples.empty()) {
+      position = table.samples.back().position;
+      heading = table.samples.back().heading;
+    }
+
+    pieces.push_back(Piece { time, duration, std::move(table), position, heading });
+    time += duration;
+  }
+
+  if (pieces.empty() || dt <= 0.0f) return out;
+
+  // one grid for the whole routine
+  size_t count = (size_t)ceilf(time / dt) + 1;
+  out.table.samples.reserve(count);
+
+  size_t p = 0;
+  for (size_t m = 0; m < count; ++m) {
+    float t = std::min((float)m * dt, time);
+    while (p + 1 < pieces.size() && pieces[p].start + pieces[p].duration <= t) ++p;
+
+    const Piece &piece = pieces[p];
+    TrajectorySample sample = piece.table.samples.empty()?
+      TrajectorySample { t, piece.hold, Vec2 { 0,0 }, 0.0f, piece.hold_heading, 0.0f } :
+      piece.table.at(t - piece.start);
+    sample.time = t;
+
+    out.table.samples.push_back(sample);
+  }
+
+  // bucket markers by the first row at or after their time
+  size_t rows = out.table.samples.size();
+  std::vector<size_t> marker_row(this->markers.size());
+  for (size_t k = 0; k < this->markers.size(); ++k) {
+    const RoutineMarker &marker = this->markers[k];
+    float start = marker.step < out.step_start.size()? out.step_start[marker.step] : 0.0f;
+    float row = ceilf((start + marker.offset) / dt);
+    marker_row[k] = (size_t)std::clamp(row, 0.0f, (float)(rows - 1));
+  }
+
+  std::vector<size_t> order(this->markers.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return marker_row[a] < marker_row[b]; });
+
+  out.marker_names.reserve(order.size());
+  out.marker_start.assign(rows + 1, 0);
+  for (size_t k : order) {
+    out.marker_names.push_back(this->markers[k].name);
+    ++out.marker_start[marker_row[k] + 1];
+  }
+  for (size_t r = 0; r < rows; ++r) out.marker_start[r+1] += out.marker_start[r];
+
+  return out;
+}
+}
@@ -0,0 +1,122 @@
+/*
+* frc-pathgen/impl/sensors.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "sensors.hpp"
+#include <imgui.h>
+#include <cmath>
+
+namespace frc_pathgen {
+
+SimulatedSensors::SimulatedSensors(SensorNoise noise, uint32_t seed) : noise(noise), rng(seed) {
+}
+
+float SimulatedSensors::gaussian(float stddev) {
+  return stddev * this->normal(this->rng);
+}
+
+void SimulatedSensors::reset(const Robot &robot, PoseEstimator &estimator) {
+  this->time = 0.0f;
+  this->gyro_bias = 0.0f;
+  this->next_frame = this->noise.vision_period;
+  this->in_flight_count = 0;
+  this->have_vision = false;
+
+  estimator.reset(Pose { robot.get_frame_center(), robot.get_rotation_radians() }, 0.0f);
+}
+
+void SimulatedSensors::tick(const Robot &robot, float dt, PoseEstimator &estimator) {
+  if (dt <= 0.0f) return;
+  this->time += dt;
+
+  // wheel odometry sees the true motion in the robot frame, each axis slipping a little
+  Vec2 travel = robot.get_velocity() * dt;
+  Vec2 forward = robot.forward();
+  Vec2 left = { -forward.y, forward.x };
+  Vec2 body = {
+    Vec2::dot(travel, forward) * (1.0f + this->gaussian(this->noise.odometry_slip)),
+    Vec2::dot(travel, left) * (1.0f + this->gaussian(this->noise.odometry_slip))
+  };
+
+  this->gyro_bias += this->gaussian(this->noise.gyro_bias_walk * sqrtf(dt));
+  float turn = robot.get_angular_velocity() * dt + this->gyro_bias * dt + this->gaussian(this->noise.gyro_noise);
+
+  estimator.predict(this->time, body, turn);
+
+  // capture
+  if (this->time >= this->next_frame) {
+    this->next_frame += this->noise.vision_period;
+    if (this->uniform(this->rng) >= this->noise.vision_dropout && this->in_flight_count < IN_FLIGHT) {
+      Pose seen = {
+        robot.get_frame_center() + Vec2 { this->gaussian(this->noise.vision_position), this->gaussian(this->noise.vision_position) },
+        robot.get_rotation_radians() + this->gaussian(this->noise.vision_heading)
+      };
+      this->in_flight[(this->in_flight_first + this->in_flight_count) % IN_FLIGHT] =
+        VisionFrame { this->time, this->time + this->noise.vision_latency, seen };
+      ++this->in_flight_count;
+    }
+  }
+
+  // delivery, stamped with the capture time so the estimator can put it where it belongs
+  while (this->in_flight_count > 0) {
+    const VisionFrame &frame = this->in_flight[this->in_flight_first];
+    if (frame.arrives > this->time) break;
+
+    estimator.add_vision(frame.captured, frame.pose, this->noise.vision_position, this->noise.vision_heading);
+    this->last_vision = frame.pose;
+    this->have_vision = true;
+
+    this->in_flight_first = (this->in_flight_first + 1) % IN_FLIGHT;
+    --this->in_flight_count;
+  }
+}
+
+void SimulatedSensors::draw(SDL_Renderer *renderer, const Viewport &viewport, const Robot &robot, const PoseEstimator &estimator) {
+  Pose estimate = estimator.get_pose();
+  float hs = Robot::wheelbase_m / 2.0f;
+  Vec2 f = { cosf(estimate.heading), sinf(estimate.heading) };
+  Vec2 l = { -f.y, f.x };
+
+  Vec2 corners[5] = {
+    estimate.position + (f + l) * hs,
+    estimate.position + (f - l) * hs,
+    estimate.position - (f + l) * hs,
+    estimate.position - (f - l) * hs,
+    estimate.position + (f + l) * hs,
+  };
+  SDL_FPoint points[5];
+  for (int i = 0; i < 5; ++i) {
+    Vec2 p = viewport.world_to_px(corners[i]);
+    points[i] = SDL_FPoint { p.x, p.y };
+  }
+
+  SDL_SetRenderDrawColor(renderer, 255, 160, 40, 255);
+  SDL_RenderDrawLinesF(renderer, points, 5);
+  Vec2 cp = viewport.world_to_px(estimate.position);
+  Vec2 hp = viewport.world_to_px(estimate.position + f * hs);
+  SDL_RenderDrawLineF(renderer, cp.x, cp.y, hp.x, hp.y);
+
+  if (this->have_vision) {
+    Vec2 vp = viewport.world_to_px(this->last_vision.position);
+    SDL_SetRenderDrawColor(renderer, 40, 200, 255, 255);
+    SDL_RenderDrawLineF(renderer, vp.x - 5, vp.y - 5, vp.x + 5, vp.y + 5);
+    SDL_RenderDrawLineF(renderer, vp.x - 5, vp.y + 5, vp.x + 5, vp.y - 5);
+  }
+
+  Vec2 error = estimate.position - robot.get_frame_center();
+  float heading_error = atan2f(sinf(estimate.heading - robot.get_rotation_radians()), cosf(estimate.heading - robot.get_rotation_radians()));
+
+  ImGui::Begin("Localization");
+  ImGui::Text("Error     %.3f m, %.2f deg", error.length(), heading_error * 180.0f / PI);
+  ImGui::Text("Sigma     %.3f m, %.2f deg", estimator.get_position_stddev(), estimator.get_heading_stddev() * 180.0f / PI);
+  ImGui::Text("Vision    %zu fused, %zu rejected, %zu too old", estimator.get_fused(), estimator.get_rejected(), estimator.get_dropped());
+  ImGui::Text("Replay    %zu steps", estimator.get_last_replay());
+  ImGui::SliderFloat("Latency (s)", &this->noise.vision_latency, 0.0f, 0.5f);
+  ImGui::SliderFloat("Odometry slip", &this->noise.odometry_slip, 0.0f, 0.2f);
+  ImGui::End();
+}
+}
@@ -0,0 +1,344 @@
+/*
+* frc-pathgen/impl/server.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "server.hpp"
+#include "lru_cache.hpp"
+#include "path_io.hpp"
+#include "thread_pool.hpp"
+#include "trajectory_cache.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace frc_pathgen {
+
+static const uint32_t MAX_REQUEST_BYTES = 1u << 20;
+static const uint32_t STATUS_OK = 0;
+static const uint32_t STATUS_ERROR = 1;
+
+static std::atomic<bool> stop_requested = false;
+
+static void handle_stop(int) {
+  stop_requested = true;
+}
+
+static bool read_full(int fd, void *data, size_t size) {
+  char *p = static_cast<char *>(data);
+  while (size > 0) {
+    ssize_t n = ::read(fd, p, size);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+static bool write_full(int fd, const void *data, size_t size) {
+  const char *p = static_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+static void append(std::string &out, const void *data, size_t size) {
+  out.append(static_cast<const char *>(data), size);
+}
+
+// whole response, header included, so a warm request is a single write of cached bytes
+static std::string encode_table(const TrajectoryTable &table) {
+  uint32_t count = table.samples.size();
+  uint32_t length = sizeof(uint32_t) + sizeof(float) + count * 8 * sizeof(float);
+
+  std::string out;
+  out.reserve(2 * sizeof(uint32_t) + length);
+  append(out, &STATUS_OK, sizeof(STATUS_OK));
+  append(out, &length, sizeof(length));
+  append(out, &count, sizeof(count));
+  append(out, &table.dt, sizeof(table.dt));
+
+  for (const TrajectorySample &s : table.samples) {
+    float row[8] = { s.time, s.position.x, s.position.y, s.velocity.x, s.velocity.y, s.kappa, s.heading, s.omega };
+    append(out, row, sizeof(row));
+  }
+  return out;
+}
+
+static std::string encode_error(const std::string &message) {
+  uint32_t length = message.size();
+
+  std::string out;
+  append(out, &STATUS_ERROR, sizeof(STATUS_ERROR));
+  append(out, &length, sizeof(length));
+  out += message;
+  return out;
+}
+
+namespace {
+struct ServerState {
+  std::mutex mutex;
+  LruCache<uint64_t, std::shared_ptr<const std::string>> responses;
+  std::unique_ptr<TrajectoryCache> disk_cache;
+  std::unordered_set<int> connections;
+
+  ServerState(size_t entries) : responses(entries) {}
+};
+}
+
+static std::shared_ptr<const std::string> respond(ServerState &state, const std::string &request) {
+  PathSpec spec;
+  std::string error;
+  if (!parse_path_spec(request, spec, error)) return std::make_shared<const std::string>(encode_error(error));
+
+  auto segments = spec.segment_pointers();
+  uint64_t key = trajectory_key(segments, spec.config, spec.dt, spec.headings);
+
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (auto *hit = state.responses.get(key)) return *hit;
+  }
+
+  // generate outside the lock, two racing misses for one key just both do the work
+  TrajectoryTable table = state.disk_cache?
+    state.disk_cache->get_or_generate(segments, spec.config, spec.dt, spec.headings) :
+    generate_trajectory(segments, spec.config, spec.dt, spec.headings);
+  auto response = std::make_shared<const std::string>(encode_table(table));
+
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.responses.put(key, response);
+  return response;
+}
+
+static void serve_connection(ServerState &state, int fd) {
+  std::string request;
+
+  for (;;) {
+    uint32_t length;
+    if (!read_full(fd, &length, sizeof(length))) break;
+    if (length > MAX_REQUEST_BYTES) {
+      std::string response = encode_error("request too large");
+      write_full(fd, response.data(), response.size());
+      break;
+    }
+
+    request.resize(length);
+    if (!read_full(fd, request.data(), length)) break;
+
+    std::shared_ptr<const std::string> response = respond(state, request);
+    if (!write_full(fd, response->data(), response->size())) break;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.connections.erase(fd);
+  }
+  ::close(fd);
+}
+
+static bool make_address(const std::filesystem::path &socket, sockaddr_un &addr) {
+  std::string path = socket.u8string();
+  if (path.size() >= sizeof(addr.sun_path)) return false;
+
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  return true;
+}
+
+// only a socket nobody is listening on may be replaced, anything else at the path is left alone
+static bool remove_stale_socket(const sockaddr_un &addr, std::string &error) {
+  struct stat st;
+  if (::lstat(addr.sun_path, &st) != 0) {
+    if (errno == ENOENT) return true;
+    error = std::strerror(errno);
+    return false;
+  }
+  if (!S_ISSOCK(st.st_mode)) {
+    error = "exists and is not a socket";
+    return false;
+  }
+
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    error = std::strerror(errno);
+    return false;
+  }
+  bool live = ::connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) == 0;
+  int connect_errno = errno;
+  ::close(fd);
+  if (live) {
+    error = "another server is already listening there";
+    return false;
+  }
+  if (connect_errno != ECONNREFUSED) {
+    error = std::strerror(connect_errno);
+    return false;
+  }
+
+  if (::unlink(addr.sun_path) != 0 && errno != ENOENT) {
+    error = std::strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+int run_server(const ServerOptions &options) {
+  sockaddr_un addr;
+  if (!make_address(options.socket, addr)) {
+    spdlog::error("Socket path too long: {}", options.socket.u8string());
+    return 1;
+  }
+
+  std::string error;
+  if (!remove_stale_socket(addr, error)) {
+    spdlog::error("Could not use {}: {}", options.socket.u8string(), error);
+    return 1;
+  }
+
+  int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    spdlog::error("Could not create socket: {}", std::strerror(errno));
+    return 1;
+  }
+
+  if (::bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || ::listen(listen_fd, 64) < 0) {
+    spdlog::error("Could not listen on {}: {}", options.socket.u8string(), std::strerror(errno));
+    ::close(listen_fd);
+    return 1;
+  }
+
+  ServerState state(options.cache_entries);
+  if (options.use_disk_cache) state.disk_cache = std::make_unique<TrajectoryCache>(default_trajectory_cache_dir());
+
+  // connections are long lived, so size the pool for clients rather than cores
+  unsigned int threads = options.threads? options.threads : std::max(8u, 2 * std::thread::hardware_concurrency());
+  ThreadPool pool(threads);
+
+  std::signal(SIGINT, handle_stop);
+  std::signal(SIGTERM, handle_stop);
+
+  spdlog::info("Serving trajectories on {} ({} connections max)", options.socket.u8string(), threads);
+
+  while (!stop_requested) {
+    pollfd pfd = { listen_fd, POLLIN, 0 };
+    if (::poll(&pfd, 1, 250) <= 0) continue;
+
+    int fd = ::accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) continue;
+
+    // every connection holds a worker until it closes, one more would just wait unanswered
+    bool full;
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      full = state.connections.size() >= threads;
+      if (!full) state.connections.insert(fd);
+    }
+    if (full) {
+      std::string response = encode_error(fmt::format("server busy, {} connections max", threads));
+      write_full(fd, response.data(), response.size());
+      // closing on an unread request would reset the connection before the client reads the error
+      ::shutdown(fd, SHUT_WR);
+      char drain[4096];
+      pollfd client = { fd, POLLIN, 0 };
+      while (::poll(&client, 1, 100) > 0 && ::read(fd, drain, sizeof(drain)) > 0) {}
+      ::close(fd);
+      spdlog::warn("Refused a connection, all {} are in use", threads);
+      continue;
+    }
+    pool.submit([&state, fd] { serve_connection(state, fd); });
+  }
+
+  spdlog::info("Shutting down");
+
+  // wake handlers blocked on idle clients so the pool can drain
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (int fd : state.connections) ::shutdown(fd, SHUT_RDWR);
+  }
+  pool.wait_idle();
+
+  ::close(listen_fd);
+  ::unlink(addr.sun_path);
+  return 0;
+}
+
+bool query_server(const std::filesystem::path &socket, const std::string &spec, TrajectoryTable &table, std::string &error) {
+  sockaddr_un addr;
+  if (!make_address(socket, addr)) {
+    error = "socket path too long";
+    return false;
+  }
+
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+    error = std::string("could not connect: ") + std::strerror(errno);
+    if (fd >= 0) ::close(fd);
+    return false;
+  }
+
+  uint32_t length = spec.size();
+  uint32_t header[2];
+  // a busy server answers before it reads anything, so its error is read even if the send failed
+  if (write_full(fd, &length, sizeof(length))) write_full(fd, spec.data(), spec.size());
+  bool ok = read_full(fd, header, sizeof(header));
+
+  std::string payload;
+  if (ok) {
+    payload.resize(header[1]);
+    ok = read_full(fd, payload.data(), payload.size());
+  }
+  ::close(fd);
+
+  if (!ok) {
+    error = "connection lost";
+    return false;
+  }
+  if (header[0] != STATUS_OK) {
+    error = payload;
+    return false;
+  }
+
+  uint32_t count;
+  if (payload.size() < sizeof(count) + sizeof(table.dt)) {
+    error = "malformed response";
+    return false;
+  }
+  std::memcpy(&count, payload.data(), sizeof(count));
+  std::memcpy(&table.dt, payload.data() + sizeof(count), sizeof(table.dt));
+  if (payload.size() != sizeof(count) + sizeof(table.dt) + count * 8 * sizeof(float)) {
+    error = "malformed response";
+    return false;
+  }
+
+  const char *rows = payload.data() + sizeof(count) + sizeof(table.dt);
+  table.samples.resize(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    float row[8];
+    std::memcpy(row, rows + i * sizeof(row), sizeof(row));
+    table.samples[i] = TrajectorySample { row[0], Vec2 { row[1], row[2] }, Vec2 { row[3], row[4] }, row[5], row[6], row[7] };
+  }
+  return true;
+}
+}
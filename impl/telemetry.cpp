@@ -0,0 +1,225 @@
+/*
+* frc-pathgen/impl/telemetry.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "telemetry.hpp"
+#include <imgui.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace frc_pathgen {
+
+static inline void merge(MinMax &into, const MinMax &m) {
+  into.lo = std::min(into.lo, m.lo);
+  into.hi = std::max(into.hi, m.hi);
+}
+
+TelemetryChannel::TelemetryChannel(const char *name, uint32_t color) : name(name), color(color),
+  levels(LEVELS * CAPACITY) {
+  this->span[0] = 1;
+  for (size_t l = 1; l < LEVELS; ++l) this->span[l] = this->span[l - 1] * FANOUT;
+  this->clear();
+}
+
+void TelemetryChannel::clear() {
+  this->total = 0;
+  for (MinMax &p : this->partial) p = { 0,0 };
+}
+
+void TelemetryChannel::push(float value) {
+  MinMax carry = { value, value };
+  this->levels[this->total % CAPACITY] = carry;
+  ++this->total;
+
+  // a completed bucket one level down feeds the bucket being filled here
+  for (size_t l = 1; l < LEVELS; ++l) {
+    uint64_t child = this->total / this->span[l - 1] - 1;
+    if (child % FANOUT == 0) this->partial[l] = carry;
+    else merge(this->partial[l], carry);
+
+    if ((child + 1) % FANOUT != 0) break;
+    uint64_t index = child / FANOUT;
+    this->levels[l * CAPACITY + index % CAPACITY] = this->partial[l];
+    carry = this->partial[l];
+  }
+}
+
+uint64_t TelemetryChannel::oldest() const {
+  uint64_t oldest = this->total;
+  for (size_t l = 0; l < LEVELS; ++l) {
+    uint64_t have = this->buckets(l);
+    oldest = std::min(oldest, (have > CAPACITY? have - CAPACITY : 0) * this->span[l]);
+  }
+  return oldest;
+}
+
+// full buckets of `level` inside the range, the ragged ends from the level below.
+// only the two ends recurse and one of them is always aligned, so this is
+// O(LEVELS * FANOUT) plus the full buckets. where the level below has already let go of
+// an end, the bucket around it stands in, a little wide but spikes never go missing
+void TelemetryChannel::merge_range(size_t level, uint64_t begin, uint64_t end, MinMax &out, bool &any) const {
+  if (begin >= end) return;
+
+  uint64_t have = this->buckets(level);
+  uint64_t first_stored = have > CAPACITY? have - CAPACITY : 0;
+  auto take = [&](const MinMax &m) {
+    if (!any) out = m;
+    else merge(out, m);
+    any = true;
+  };
+
+  if (level == 0) {
+    for (uint64_t i = std::max(begin, first_stored); i < std::min(end, have); ++i) take(this->bucket(0, i));
+    return;
+  }
+
+  uint64_t s = this->span[level];
+  uint64_t below = this->buckets(level - 1);
+  uint64_t below_oldest = (below > CAPACITY? below - CAPACITY : 0) * this->span[level - 1];
+
+  // a ragged end, from the level below if it still has it
+  auto edge = [&](uint64_t a, uint64_t b) {
+    if (a >= b) return;
+    if (a >= below_oldest) {
+      this->merge_range(level - 1, a, b, out, any);
+      return;
+    }
+    for (uint64_t k = std::max(a / s, first_stored); k <= (b - 1) / s && k < have; ++k) take(this->bucket(level, k));
+    // the part too new for a complete bucket here is always in the level below
+    if (have * s < b) this->merge_range(level - 1, std::max(a, have * s), b, out, any);
+  };
+
+  uint64_t first = (begin + s - 1) / s;
+  uint64_t last = std::min(end / s, have);
+  if (first >= last) {
+    edge(begin, end);
+    return;
+  }
+
+  for (uint64_t b = std::max(first, first_stored); b < last; ++b) take(this->bucket(level, b));
+  edge(begin, first * s);
+  edge(last * s, end);
+}
+
+bool TelemetryChannel::range(uint64_t begin, uint64_t end, MinMax &out) const {
+  bool any = false;
+  this->merge_range(LEVELS - 1, begin, std::min(end, this->total), out, any);
+  return any;
+}
+
+void TelemetryChannel::decimate(uint64_t begin, uint64_t end, size_t columns, MinMax *out, bool *valid) const {
+  uint64_t length = end > begin? end - begin : 0;
+  for (size_t c = 0; c < columns; ++c) {
+    uint64_t b0 = begin + length * c / columns;
+    uint64_t b1 = begin + length * (c + 1) / columns;
+    valid[c] = this->range(b0, b1, out[c]);
+  }
+}
+
+void TelemetryPlot::draw(const char *label, const TelemetryChannel *const *channels, size_t count, float height) {
+  ImVec2 origin = ImGui::GetCursorScreenPos();
+  float width = std::max(ImGui::GetContentRegionAvail().x, 16.0f);
+  ImGui::Dummy(ImVec2(width, height));
+  if (!ImGui::IsItemVisible() || count == 0) return;
+
+  ImDrawList *draw_list = ImGui::GetWindowDrawList();
+  ImVec2 corner = ImVec2(origin.x + width, origin.y + height);
+  draw_list->AddRectFilled(origin, corner, IM_COL32(20, 20, 24, 255));
+  draw_list->AddRect(origin, corner, IM_COL32(70, 70, 80, 255));
+
+  // the span every channel still has
+  uint64_t begin = 0, end = 0;
+  for (size_t i = 0; i < count; ++i) {
+    begin = std::max(begin, channels[i]->oldest());
+    end = std::max(end, channels[i]->size());
+  }
+
+  MinMax bounds = { 0,0 };
+  bool any = false;
+  for (size_t i = 0; i < count; ++i) {
+    MinMax r;
+    if (!channels[i]->range(begin, end, r)) continue;
+    if (!any) bounds = r;
+    else merge(bounds, r);
+    any = true;
+  }
+  if (!any) {
+    draw_list->AddText(ImVec2(origin.x + 4, origin.y + 2), IM_COL32(200, 200, 200, 255), label);
+    return;
+  }
+  if (bounds.hi - bounds.lo < 1e-6f) {
+    bounds.lo -= 0.5f;
+    bounds.hi += 0.5f;
+  }
+
+  float top = origin.y + 2.0f, bottom = corner.y - 2.0f;
+  float scale = (bottom - top) / (bounds.hi - bounds.lo);
+  auto to_y = [&](float v) { return bottom - (v - bounds.lo) * scale; };
+
+  if (bounds.lo < 0.0f && bounds.hi > 0.0f) {
+    draw_list->AddLine(ImVec2(origin.x, to_y(0.0f)), ImVec2(corner.x, to_y(0.0f)), IM_COL32(60, 60, 70, 255));
+  }
+
+  size_t columns = (size_t)std::min<uint64_t>(std::min<uint64_t>((uint64_t)width, MAX_COLUMNS), end - begin);
+  float column_width = width / std::max<size_t>(columns, 1);
+
+  draw_list->PushClipRect(origin, corner, true);
+  for (size_t i = 0; i < count; ++i) {
+    channels[i]->decimate(begin, end, columns, this->columns, this->valid);
+    uint32_t color = channels[i]->get_color();
+
+    bool have_previous = false;
+    MinMax previous = { 0,0 };
+    float previous_x = 0.0f;
+    for (size_t c = 0; c < columns; ++c) {
+      if (!this->valid[c]) {
+        have_previous = false;
+        continue;
+      }
+      MinMax m = this->columns[c];
+      float x = origin.x + (c + 0.5f) * column_width;
+
+      if (have_previous && column_width > 1.5f) {
+        // few samples, join the dots
+        draw_list->AddLine(ImVec2(previous_x, to_y(0.5f * (previous.lo + previous.hi))),
+          ImVec2(x, to_y(0.5f * (m.lo + m.hi))), color);
+      } else {
+        // the envelope reaches back to the last column so steep edges stay connected
+        MinMax span = m;
+        if (have_previous) {
+          span.lo = std::min(span.lo, previous.hi);
+          span.hi = std::max(span.hi, previous.lo);
+        }
+        draw_list->AddLine(ImVec2(x, to_y(span.hi)), ImVec2(x, to_y(span.lo) + 1.0f), color);
+      }
+
+      previous = m;
+      previous_x = x;
+      have_previous = true;
+    }
+  }
+  draw_list->PopClipRect();
+
+  // label, legend and scale
+  char text[64];
+  float x = origin.x + 4.0f;
+  draw_list->AddText(ImVec2(x, origin.y + 2.0f), IM_COL32(200, 200, 200, 255), label);
+  x += ImGui::CalcTextSize(label).x + 12.0f;
+  for (size_t i = 0; i < count; ++i) {
+    draw_list->AddText(ImVec2(x, origin.y + 2.0f), channels[i]->get_color(), channels[i]->get_name());
+    x += ImGui::CalcTextSize(channels[i]->get_name()).x + 12.0f;
+  }
+
+  snprintf(text, sizeof(text), "%.3g", bounds.hi);
+  draw_list->AddText(ImVec2(corner.x - ImGui::CalcTextSize(text).x - 4.0f, origin.y + 2.0f), IM_COL32(140, 140, 140, 255), text);
+  snprintf(text, sizeof(text), "%.3g", bounds.lo);
+  draw_list->AddText(ImVec2(corner.x - ImGui::CalcTextSize(text).x - 4.0f, bottom - ImGui::GetFontSize()), IM_COL32(140, 140, 140, 255), text);
+  snprintf(text, sizeof(text), "%llu samples", (unsigned long long)(end - begin));
+  draw_list->AddText(ImVec2(origin.x + 4.0f, bottom - ImGui::GetFontSize()), IM_COL32(140, 140, 140, 255), text);
+}
+}
@@ -0,0 +1,68 @@
+/*
+* frc-pathgen/impl/thread_pool.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "thread_pool.hpp"
+
+namespace frc_pathgen {
+
+ThreadPool::ThreadPool(unsigned int threads) {
+  if (threads == 0) threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+
+  this->workers.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i) {
+    this->workers.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopping = true;
+  }
+  this->job_ready.notify_all();
+
+  for (std::thread &worker : this->workers) worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->jobs.push_back(std::move(job));
+  }
+  this->job_ready.notify_one();
+}
+
+void ThreadPool::wait_idle() {
+  std::unique_lock<std::mutex> lock(this->mutex);
+  this->idle.wait(lock, [this] { return this->jobs.empty() && this->busy == 0; });
+}
+
+void ThreadPool::work() {
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->job_ready.wait(lock, [this] { return this->stopping || !this->jobs.empty(); });
+      if (this->jobs.empty()) return; // stopping, and nothing left to do
+
+      job = std::move(this->jobs.front());
+      this->jobs.pop_front();
+      ++this->busy;
+    }
+
+    job();
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      --this->busy;
+      if (this->busy == 0 && this->jobs.empty()) this->idle.notify_all();
+    }
+  }
+}
+}
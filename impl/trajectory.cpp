@@ -0,0 +1,438 @@
+/*
+* frc-pathgen/impl/trajectory.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "trajectory.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace frc_pathgen {
+
+float curvature_vmax(float kappa, float max_acceleration, float margin) {
+  return margin * sqrtf(max_acceleration / fmaxf(1e-4f, fabsf(kappa)));
+}
+
+float path_curvature(const Path &path, float t) {
+  return path.curvature(t);
+}
+
+TrajectorySample TrajectoryTable::at(float time) const {
+  if (this->samples.empty()) return TrajectorySample { time, Vec2 { 0,0 }, Vec2 { 0,0 }, 0.0f };
+
+  size_t last = this->samples.size() - 1;
+  float index = std::clamp(time / this->dt, 0.0f, (float)last);
+  size_t i = std::min((size_t)index, last);
+  if (i == last) return this->samples[last];
+
+  const TrajectorySample &a = this->samples[i];
+  const TrajectorySample &b = this->samples[i+1];
+  // the last row may be closer than dt to the one before it
+  float span = b.time - a.time;
+  float f = span > 0.0f? std::clamp((time - a.time) / span, 0.0f, 1.0f) : 0.0f;
+
+  return TrajectorySample {
+    time,
+    a.position * (1.0f - f) + b.position * f,
+    a.velocity * (1.0f - f) + b.velocity * f,
+    a.kappa * (1.0f - f) + b.kappa * f,
+    a.heading * (1.0f - f) + b.heading * f,
+    a.omega * (1.0f - f) + b.omega * f
+  };
+}
+
+Trajectory::Trajectory(TrajectoryConfig config) : config(config) {
+}
+
+void Trajectory::set_segments(std::vector<const Path *> segments, std::vector<HeadingWaypoint> headings) {
+  this->segments = std::move(segments);
+  this->headings = std::move(headings);
+
+  size_t n = this->segments.empty()? 0 : this->segments.size() * this->config.samples_per_segment + 1;
+
+  this->position.assign(n, Vec2 { 0,0 });
+  this->tangent.assign(n, Vec2 { 0,0 });
+  this->kappa.assign(n, 0.0f);
+  this->heading.assign(n, 0.0f);
+  this->dheading.assign(n, 0.0f);
+  this->ddheading.assign(n, 0.0f);
+  this->vlimit.assign(n, 0.0f);
+  this->vforward.assign(n, 0.0f);
+  this->velocity.assign(n, 0.0f);
+  this->ds.assign(n? n-1 : 0, 0.0f);
+  this->dt.assign(n? n-1 : 0, 0.0f);
+  this->segment_duration.assign(this->segments.size(), 0.0f);
+  this->segment_length.assign(this->segments.size(), 0.0f);
+
+  this->heading_knots.clear();
+  if (n == 0) {
+    this->update_span = 0;
+    return;
+  }
+
+  std::vector<HeadingWaypoint> sorted = this->headings;
+  std::stable_sort(sorted.begin(), sorted.end(), [](const HeadingWaypoint &a, const HeadingWaypoint &b) { return a.u < b.u; });
+  if (sorted.empty() || sorted[0].u > 0.0f) this->heading_knots.push_back({ 0, 0.0f });
+  for (const HeadingWaypoint &waypoint : sorted) {
+    float u = std::clamp(waypoint.u, 0.0f, (float)this->segments.size());
+    size_t knot = (size_t)lroundf(u * (float)this->config.samples_per_segment);
+
+    // the short way round from the previous waypoint
+    float h = waypoint.heading;
+    if (!this->heading_knots.empty()) {
+      float previous = this->heading_knots.back().second;
+      h = previous + atan2f(sinf(h - previous), cosf(h - previous));
+    }
+    this->heading_knots.push_back({ knot, h });
+  }
+
+  for (size_t k = 0; k < this->segments.size(); ++k) this->sample_segment(k);
+
+  this->solve_headings(0, n);
+  this->forward_pass(0, n);
+  this->backward_pass(n, 0);
+  this->update_times(0, n);
+  this->update_span = n;
+}
+
+void Trajectory::set_headings(std::vector<HeadingWaypoint> headings) {
+  std::vector<const Path *> segments = this->segments;
+  this->set_segments(std::move(segments), std::move(headings));
+}
+
+void Trajectory::update_segment(size_t index) {
+  if (index >= this->segments.size()) return;
+
+  size_t N = this->config.samples_per_segment;
+
+  this->sample_segment(index);
+
+  // the heading between the waypoints around this segment is spread over their arc length
+  size_t lo = index * N;
+  size_t hi = (index + 1) * N + 1;
+  this->heading_span(lo, hi);
+  this->solve_headings(lo, hi);
+
+  size_t fwd_end = this->forward_pass(lo, hi);
+  size_t bwd_begin = this->backward_pass(fwd_end, lo);
+
+  this->update_times(bwd_begin > 0? bwd_begin - 1 : 0, fwd_end);
+  this->update_span = fwd_end - bwd_begin;
+}
+
+void Trajectory::sample_segment(size_t index) {
+  const Path &path = *this->segments[index];
+  size_t N = this->config.samples_per_segment;
+  size_t base = index * N;
+
+  // every knot's position, tangent and curvature in one batch, analytic where the path has closed forms
+  this->scratch_t.resize(N + 1);
+  this->scratch_points.resize(N + 1);
+  for (size_t j = 0; j <= N; ++j) this->scratch_t[j] = (float)j / (float)N;
+  path.sample_derivatives(this->scratch_t.data(), this->scratch_points.data(), N + 1);
+
+  for (size_t j = 0; j <= N; ++j) {
+    size_t i = base + j;
+
+    const PathPoint &point = this->scratch_points[j];
+    float speed = point.velocity.length();
+
+    this->position[i] = point.position;
+    this->tangent[i] = speed > 1e-6f? point.velocity / speed : Vec2 { 0,0 };
+
+    float k = point.kappa;
+
+    // a knot shared with a neighbour has to respect the sharper side of the joint
+    if (j == 0 && index > 0) {
+      float other = this->segments[index-1]->curvature(1.0f);
+      if (fabsf(other) > fabsf(k)) k = other;
+    } else if (j == N && index + 1 < this->segments.size()) {
+      float other = this->segments[index+1]->curvature(0.0f);
+      if (fabsf(other) > fabsf(k)) k = other;
+    }
+
+    this->kappa[i] = k;
+  }
+
+  // paths that stop dead at their ends (LinePath) have no tangent there, use the chord
+  for (size_t j = 0; j <= N; ++j) {
+    size_t i = base + j;
+    if (this->tangent[i].length() > 0.0f) continue;
+
+    Vec2 chord = j < N? this->position[i+1] - this->position[i] : this->position[i] - this->position[i-1];
+    float len = chord.length();
+    if (len > 1e-9f) this->tangent[i] = chord / len;
+  }
+
+  size_t first = base > 0? base - 1 : base;
+  for (size_t i = first; i < base + N; ++i) {
+    this->ds[i] = (this->position[i+1] - this->position[i]).length();
+  }
+}
+
+void Trajectory::heading_span(size_t &begin, size_t &end) const {
+  const auto &knots = this->heading_knots;
+
+  // past the last waypoint the heading is constant, only a span between two of them widens
+  size_t w = 0;
+  while (w + 1 < knots.size() && knots[w+1].first <= begin) ++w;
+  if (w + 1 < knots.size()) begin = knots[w].first;
+
+  for (const auto &knot : knots) {
+    if (knot.first < end) continue;
+    end = std::min(knot.first + 1, this->velocity.size());
+    break;
+  }
+}
+
+void Trajectory::solve_headings(size_t begin, size_t end) {
+  const auto &knots = this->heading_knots;
+  size_t last = this->velocity.size() - 1;
+
+  size_t w = 0;
+  while (w + 1 < knots.size() && knots[w+1].first <= begin) ++w;
+
+  size_t i = begin;
+  while (i < end) {
+    float from = knots[w].second;
+
+    if (w + 1 == knots.size()) {
+      for (; i < end; ++i) {
+        this->heading[i] = from;
+        this->dheading[i] = 0.0f;
+        this->ddheading[i] = 0.0f;
+      }
+      break;
+    }
+
+    // quintic smoothstep over the arc length between waypoints w and w+1, which starts and
+    // ends with no angular velocity or acceleration
+    size_t a = knots[w].first, b = knots[w+1].first;
+    float delta = knots[w+1].second - from;
+
+    double length = 0.0, s = 0.0;
+    for (size_t j = a; j < b; ++j) {
+      if (j < i) s += this->ds[j];
+      length += this->ds[j];
+    }
+
+    for (; i < std::min(b, end); ++i) {
+      if (length < 1e-6) {
+        this->heading[i] = knots[w+1].second;
+        this->dheading[i] = 0.0f;
+        this->ddheading[i] = 0.0f;
+        continue;
+      }
+
+      float x = (float)(s / length), L = (float)length;
+      this->heading[i] = from + delta * x * x * x * (10.0f + x * (-15.0f + 6.0f * x));
+      this->dheading[i] = delta * 30.0f * x * x * (1.0f - x) * (1.0f - x) / L;
+      this->ddheading[i] = delta * 60.0f * x * (1.0f - x) * (1.0f - 2.0f * x) / (L * L);
+      s += this->ds[i];
+    }
+    ++w;
+  }
+
+  float r = this->config.turn_radius, margin = this->config.curvature_margin;
+  float a = this->config.max_acceleration, alpha = this->config.max_angular_acceleration;
+  for (size_t i = begin; i < end; ++i) {
+    if (i == 0 || i == last) {
+      this->vlimit[i] = 0.0f;
+      continue;
+    }
+
+    // the wheels turning the robot run at v * (1 + |dheading/ds| * r), keep those under the free speed
+    float limit = this->config.max_velocity / (1.0f + fabsf(this->dheading[i]) * r);
+    // cornering and spinning up share the wheels' grip: v^2 (|kappa| / a + |ddheading| / alpha) <= margin^2,
+    // margin scaling speed as in curvature_vmax
+    float demand = fmaxf(1e-4f, fabsf(this->kappa[i])) / a + fabsf(this->ddheading[i]) / alpha;
+    limit = fminf(limit, margin * sqrtf(1.0f / demand));
+
+    this->vlimit[i] = limit;
+  }
+}
+
+float Trajectory::acceleration_limit(size_t i, float v) const {
+  float a = this->config.max_acceleration;
+  float k = fmaxf(fabsf(this->kappa[i]), fabsf(this->kappa[i+1]));
+  float d1 = fmaxf(fabsf(this->dheading[i]), fabsf(this->dheading[i+1]));
+  float d2 = fmaxf(fabsf(this->ddheading[i]), fabsf(this->ddheading[i+1]));
+  if (k == 0.0f && d1 == 0.0f && d2 == 0.0f) return a;
+
+  // |accel| / a + k v^2 / a + |d2 v^2 + d1 accel| / alpha <= 1, with the worst sign on both turning terms.
+  // the centripetal and angular shares come off the top, what's left drives along the path
+  float alpha = this->config.max_angular_acceleration;
+  float left = fmaxf(0.0f, 1.0f - k * v * v / a - d2 * v * v / alpha);
+  return left / (1.0f / a + d1 / alpha);
+}
+
+// returns one past the last knot that changed
+size_t Trajectory::forward_pass(size_t begin, size_t min_end) {
+  size_t n = this->velocity.size();
+
+  size_t i = begin;
+  for (; i < n; ++i) {
+    float v = this->vlimit[i];
+    if (i > 0) {
+      float u = this->vforward[i-1];
+      v = fminf(v, sqrtf(u * u + 2.0f * this->acceleration_limit(i-1, u) * this->ds[i-1]));
+    }
+
+    if (i >= min_end && v == this->vforward[i]) break;
+    this->vforward[i] = v;
+  }
+
+  return i;
+}
+
+// walks down from end-1, returns the first knot that changed
+size_t Trajectory::backward_pass(size_t end, size_t min_begin) {
+  size_t n = this->velocity.size();
+
+  size_t i = end;
+  while (i > 0) {
+    --i;
+    float v = this->vforward[i];
+    if (i + 1 < n) {
+      float u = this->velocity[i+1];
+      v = fminf(v, sqrtf(u * u + 2.0f * this->acceleration_limit(i, u) * this->ds[i]));
+    }
+
+    if (i < min_begin && v == this->velocity[i]) return i + 1;
+    this->velocity[i] = v;
+  }
+
+  return 0;
+}
+
+void Trajectory::update_times(size_t begin, size_t end) {
+  size_t intervals = this->dt.size();
+  end = std::min(end, intervals);
+  if (begin >= end) return;
+
+  for (size_t i = begin; i < end; ++i) {
+    float vsum = this->velocity[i] + this->velocity[i+1];
+    this->dt[i] = vsum > 1e-6f? 2.0f * this->ds[i] / vsum : 0.0f;
+  }
+
+  size_t N = this->config.samples_per_segment;
+  for (size_t k = begin / N; k <= (end - 1) / N; ++k) {
+    float duration = 0.0f, length = 0.0f;
+    for (size_t i = k * N; i < (k + 1) * N; ++i) {
+      duration += this->dt[i];
+      length += this->ds[i];
+    }
+    this->segment_duration[k] = duration;
+    this->segment_length[k] = length;
+  }
+}
+
+// summed in double, float drifts visibly over a few hundred segments
+float Trajectory::duration() const {
+  double total = 0.0;
+  for (float d : this->segment_duration) total += d;
+  return (float)total;
+}
+
+float Trajectory::length() const {
+  double total = 0.0;
+  for (float l : this->segment_length) total += l;
+  return (float)total;
+}
+
+TrajectorySample Trajectory::interpolate(size_t i, float tau) const {
+  size_t N = this->config.samples_per_segment;
+  float v0 = this->velocity[i], v1 = this->velocity[i+1];
+  float a = this->dt[i] > 0.0f? (v1 - v0) / this->dt[i] : 0.0f;
+
+  tau = std::clamp(tau, 0.0f, this->dt[i]);
+  float s = v0 * tau + 0.5f * a * tau * tau;
+  float frac = this->ds[i] > 0.0f? std::clamp(s / this->ds[i], 0.0f, 1.0f) : 0.0f;
+
+  size_t k = i / N;
+  float t = ((float)(i - k * N) + frac) / (float)N;
+
+  Vec2 dir = this->tangent[i] * (1.0f - frac) + this->tangent[i+1] * frac;
+  float len = dir.length();
+  if (len > 1e-9f) dir = dir / len;
+
+  TrajectorySample sample;
+  sample.time = tau;
+  sample.position = this->segments[k]->sample_position(t);
+  sample.velocity = dir * (v0 + a * tau);
+  sample.kappa = this->kappa[i] * (1.0f - frac) + this->kappa[i+1] * frac;
+  sample.heading = this->heading[i] * (1.0f - frac) + this->heading[i+1] * frac;
+  sample.omega = (this->dheading[i] * (1.0f - frac) + this->dheading[i+1] * frac) * (v0 + a * tau);
+  return sample;
+}
+
+TrajectorySample Trajectory::sample(float time) const {
+  if (this->segments.empty()) return TrajectorySample { 0.0f, Vec2 { 0,0 }, Vec2 { 0,0 }, 0.0f };
+
+  size_t N = this->config.samples_per_segment;
+  time = std::clamp(time, 0.0f, this->duration());
+
+  float start = 0.0f;
+  size_t k = 0;
+  while (k + 1 < this->segments.size() && start + this->segment_duration[k] < time) {
+    start += this->segment_duration[k];
+    ++k;
+  }
+
+  size_t i = k * N;
+  while (i + 1 < (k + 1) * N && start + this->dt[i] < time) {
+    start += this->dt[i];
+    ++i;
+  }
+
+  TrajectorySample sample = this->interpolate(i, time - start);
+  sample.time = time;
+  return sample;
+}
+
+TrajectoryTable Trajectory::to_table(float dt) const {
+  TrajectoryTable table;
+  table.dt = dt;
+  if (this->segments.empty() || dt <= 0.0f) return table;
+
+  float duration = this->duration();
+  size_t count = (size_t)ceilf(duration / dt) + 1;
+  table.samples.reserve(count);
+
+  float segment_start = 0.0f;
+  for (float d : this->segment_duration) {
+    table.segment_start.push_back(segment_start);
+    segment_start += d;
+  }
+
+  // single cursor walk, the table is generated in time order
+  size_t intervals = this->dt.size();
+  size_t i = 0;
+  double start = 0.0;
+
+  for (size_t m = 0; m < count; ++m) {
+    float time = std::min((float)m * dt, duration);
+
+    while (i + 1 < intervals && start + this->dt[i] < time) {
+      start += this->dt[i];
+      ++i;
+    }
+
+    TrajectorySample sample = this->interpolate(i, (float)(time - start));
+    sample.time = time;
+    table.samples.push_back(sample);
+  }
+
+  return table;
+}
+
+TrajectoryTable generate_trajectory(const std::vector<const Path *> &segments, const TrajectoryConfig &config, float dt,
+  const std::vector<HeadingWaypoint> &headings) {
+  Trajectory trajectory(config);
+  trajectory.set_segments(segments, headings);
+  return trajectory.to_table(dt);
+}
+}
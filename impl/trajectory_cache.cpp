@@ -0,0 +1,270 @@
+/*
+* frc-pathgen/impl/trajectory_cache.cpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#include "trajectory_cache.hpp"
+#include "hash.hpp"
+#include <SDL2/SDL.h>
+#include <spdlog/spdlog.h>
+#include <spdlog/fmt/fmt.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+
+namespace frc_pathgen {
+
+// bump whenever the file layout or the generator output changes
+static const uint32_t CACHE_FORMAT_VERSION = 6;
+
+struct CacheHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t count;
+  uint32_t segments;
+  float dt;
+};
+
+// a .tmp older than this was left by a writer that died, a live one renames it within a second
+static const auto STALE_TMP_AGE = std::chrono::minutes(10);
+
+// only names file_for() writes: 16 lowercase hex digits, so every key has exactly one file
+static bool parse_key(const std::string &stem, uint64_t &key) {
+  if (stem.size() != 16) return false;
+  for (char c : stem) {
+    if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return false;
+  }
+  return std::from_chars(stem.data(), stem.data() + stem.size(), key, 16).ec == std::errc();
+}
+
+static uintmax_t entry_size(uint32_t count, uint32_t segments) {
+  return sizeof(CacheHeader) + (uintmax_t)count * sizeof(TrajectorySample) + (uintmax_t)segments * sizeof(float);
+}
+
+uint64_t trajectory_key(const std::vector<const Path *> &segments, const TrajectoryConfig &config, float dt,
+  const std::vector<HeadingWaypoint> &headings) {
+  Hasher hasher;
+  hasher.add(CACHE_FORMAT_VERSION);
+
+  hasher.add(segments.size());
+  for (const Path *segment : segments) segment->hash_geometry(hasher);
+
+  hasher.add(headings.size());
+  for (const HeadingWaypoint &waypoint : headings) {
+    hasher.add(waypoint.u);
+    hasher.add(waypoint.heading);
+  }
+
+  hasher.add(Robot::mass);
+  hasher.add(Robot::wheelbase);
+  hasher.add(Robot::wheel_dist);
+  hasher.add(Robot::moi);
+  hasher.add(Robot::wheel_torque);
+  hasher.add(Robot::wheel_radius);
+
+  hasher.add(config.samples_per_segment);
+  hasher.add(config.max_velocity);
+  hasher.add(config.max_acceleration);
+  hasher.add(config.curvature_margin);
+  hasher.add(config.max_angular_acceleration);
+  hasher.add(config.turn_radius);
+  hasher.add(dt);
+
+  return hasher.digest();
+}
+
+std::filesystem::path default_trajectory_cache_dir() {
+  char *usrdir = SDL_GetPrefPath("FRC-8193", "frc-pathgen");
+  if (!usrdir) return std::filesystem::temp_directory_path() / "frc-pathgen" / "trajectories";
+
+  auto dir = std::filesystem::path(usrdir) / "trajectories";
+  SDL_free(usrdir);
+  return dir;
+}
+
+TrajectoryCache::TrajectoryCache(std::filesystem::path directory, uintmax_t max_bytes) :
+  directory(std::move(directory)), max_bytes(max_bytes) {
+  std::error_code ec;
+  std::filesystem::create_directories(this->directory, ec);
+  if (ec) {
+    spdlog::warn("Could not create trajectory cache at {}: {}", this->directory.u8string(), ec.message());
+    return;
+  }
+
+  struct Found {
+    std::filesystem::file_time_type time;
+    uint64_t key;
+    uintmax_t size;
+  };
+  std::vector<Found> found;
+
+  for (auto &file : std::filesystem::directory_iterator(this->directory, ec)) {
+    if (file.path().extension() == ".tmp") {
+      // another process sharing the directory may be writing it right now
+      std::error_code fec;
+      auto time = file.last_write_time(fec);
+      if (!fec && std::filesystem::file_time_type::clock::now() - time > STALE_TMP_AGE) std::filesystem::remove(file.path(), fec);
+      continue;
+    }
+    if (file.path().extension() != ".traj") continue;
+
+    uint64_t key;
+    if (!parse_key(file.path().stem().u8string(), key)) continue; // not ours
+
+    std::error_code fec;
+    auto time = file.last_write_time(fec);
+    auto size = file.file_size(fec);
+    if (fec) continue;
+
+    found.push_back({ time, key, size });
+  }
+
+  // most recently used first
+  std::sort(found.begin(), found.end(), [](const Found &a, const Found &b) { return a.time > b.time; });
+
+  for (const Found &f : found) {
+    this->lru.push_back(f.key);
+    this->entries[f.key] = Entry { f.size, std::prev(this->lru.end()) };
+    this->total_bytes += f.size;
+  }
+
+  this->evict();
+
+  spdlog::info("Trajectory cache: {} entries, {} KiB in {}", this->entries.size(), this->total_bytes / 1024, this->directory.u8string());
+}
+
+std::filesystem::path TrajectoryCache::file_for(uint64_t key) const {
+  return this->directory / fmt::format("{:016x}.traj", key);
+}
+
+// file IO happens outside the lock so parallel generators only contend on the index
+bool TrajectoryCache::load(uint64_t key, TrajectoryTable &table) {
+  uintmax_t size;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->entries.find(key);
+    if (it == this->entries.end()) return false;
+    size = it->second.size;
+  }
+
+  std::filesystem::path path = this->file_for(key);
+  std::ifstream in(path, std::ios::binary);
+  CacheHeader header;
+  bool ok = in && in.read(reinterpret_cast<char *>(&header), sizeof(header)) &&
+    std::equal(header.magic, header.magic + 4, "FPTC") && header.version == CACHE_FORMAT_VERSION &&
+    size == entry_size(header.count, header.segments);
+
+  if (ok) {
+    table.dt = header.dt;
+    table.samples.resize(header.count);
+    table.segment_start.resize(header.segments);
+    ok = in.read(reinterpret_cast<char *>(table.samples.data()), header.count * sizeof(TrajectorySample)) &&
+      in.read(reinterpret_cast<char *>(table.segment_start.data()), header.segments * sizeof(float));
+  }
+
+  std::error_code ec;
+  if (!ok) {
+    spdlog::warn("Dropping unreadable trajectory cache entry {:016x}", key);
+    std::filesystem::remove(path, ec);
+    this->forget(key);
+    return false;
+  }
+
+  std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto it = this->entries.find(key);
+  if (it != this->entries.end()) this->lru.splice(this->lru.begin(), this->lru, it->second.lru_position);
+  return true;
+}
+
+void TrajectoryCache::store(uint64_t key, const TrajectoryTable &table) {
+  CacheHeader header = { { 'F', 'P', 'T', 'C' }, CACHE_FORMAT_VERSION,
+    (uint32_t)table.samples.size(), (uint32_t)table.segment_start.size(), table.dt };
+  uintmax_t size = entry_size(header.count, header.segments);
+
+  // write aside and rename so a crash (or a concurrent reader) never sees a torn entry
+  std::filesystem::path path = this->file_for(key);
+  std::filesystem::path tmp = path;
+  // unique across the threads and the processes (batch, serve, the GUI) sharing the directory
+  static std::atomic<uint64_t> writes = 0;
+  tmp += fmt::format(".{}.{}.tmp", (long)getpid(), writes.fetch_add(1, std::memory_order_relaxed));
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(table.samples.data()), table.samples.size() * sizeof(TrajectorySample));
+    out.write(reinterpret_cast<const char *>(table.segment_start.data()), table.segment_start.size() * sizeof(float));
+    if (!out) {
+      spdlog::warn("Could not write trajectory cache entry {}", tmp.u8string());
+      return;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp, path, ec);
+  if (ec) {
+    spdlog::warn("Could not write trajectory cache entry {}: {}", path.u8string(), ec.message());
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto it = this->entries.find(key);
+  if (it != this->entries.end()) {
+    this->total_bytes -= it->second.size;
+    this->lru.erase(it->second.lru_position);
+  }
+  this->lru.push_front(key);
+  this->entries[key] = Entry { size, this->lru.begin() };
+  this->total_bytes += size;
+
+  this->evict();
+}
+
+TrajectoryTable TrajectoryCache::get_or_generate(const std::vector<const Path *> &segments, const TrajectoryConfig &config, float dt,
+  const std::vector<HeadingWaypoint> &headings) {
+  uint64_t key = trajectory_key(segments, config, dt, headings);
+
+  TrajectoryTable table;
+  if (this->load(key, table)) {
+    ++this->hits;
+    return table;
+  }
+
+  ++this->misses;
+  table = generate_trajectory(segments, config, dt, headings);
+  this->store(key, table);
+  return table;
+}
+
+void TrajectoryCache::forget(uint64_t key) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto it = this->entries.find(key);
+  if (it == this->entries.end()) return;
+
+  this->total_bytes -= it->second.size;
+  this->lru.erase(it->second.lru_position);
+  this->entries.erase(it);
+}
+
+// caller holds the lock
+void TrajectoryCache::evict() {
+  while (this->total_bytes > this->max_bytes && !this->lru.empty()) {
+    uint64_t key = this->lru.back();
+    this->lru.pop_back();
+    auto it = this->entries.find(key);
+    if (it == this->entries.end()) continue;
+
+    std::error_code ec;
+    std::filesystem::remove(this->file_for(key), ec);
+
+    this->total_bytes -= it->second.size;
+    this->entries.erase(it);
+  }
+}
+}
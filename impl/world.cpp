@@ -9,11 +9,10 @@
 #include "world.hpp"
 #include "gfx.hpp"
 #include <cmath>
-#include <spdlog/fmt/fmt.h>
 
 namespace frc_pathgen {
 
-void draw_world_gridlines(SDL_Renderer *r, TTF_Font *font, const Viewport &vp) {
+void draw_world_gridlines(SDL_Renderer *r, const GlyphAtlas &labels, FrameArena &arena, const Viewport &vp) {
   float units_per_px = vp.units_per_vw / vp.width;
   float px_per_unit  = 1.0f / units_per_px;
 
@@ -55,9 +54,9 @@ void draw_world_gridlines(SDL_Renderer *r, TTF_Font *font, const Viewport &vp) {
     SDL_RenderDrawLineF(r, p0.x, p0.y, p1.x, p1.y);
 
     // --- Label ---
-    if (is_major && font && fabsf(x) > 1e-5f) {
+    if (is_major && labels.is_ok() && fabsf(x) > 1e-5f) {
       Vec2 label_pos = vp.world_to_px({x, 0});
-      draw_text(r, font, fmt::format("{:.2g}", x), label_pos.x + 2, label_pos.y + 2);
+      draw_text(r, labels, arena.format("{:.2g}", x), label_pos.x + 2, label_pos.y + 2);
     }
   }
 
@@ -81,9 +80,9 @@ void draw_world_gridlines(SDL_Renderer *r, TTF_Font *font, const Viewport &vp) {
     SDL_RenderDrawLineF(r, p0.x, p0.y, p1.x, p1.y);
 
     // --- Label ---
-    if (is_major && font && fabsf(y) > 1e-5f) {
+    if (is_major && labels.is_ok() && fabsf(y) > 1e-5f) {
       Vec2 label_pos = vp.world_to_px({0, y});
-      draw_text(r, font, fmt::format("{:.2g}", y), label_pos.x + 4, label_pos.y + 4);
+      draw_text(r, labels, arena.format("{:.2g}", y), label_pos.x + 4, label_pos.y + 4);
     }
   }
 }
@@ -0,0 +1,79 @@
+/*
+* frc-pathgen/include/alloc_stats.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Heap allocation counters for the frame loop, compiled in with -DFRC_PATHGEN_ALLOC_STATS=ON.
+// That build replaces the global operator new/delete, SDL's allocator and ImGui's with
+// counting versions, and charges each allocation to the innermost AllocScope on the calling thread.
+// In normal builds every call here is empty and compiles away.
+
+namespace frc_pathgen {
+
+enum class AllocSubsystem {
+  OTHER,
+  EVENTS,
+  PHYSICS,
+  WORLD,
+  ROBOT,
+  FOLLOWER,
+  PATH,
+  UI,
+  COUNT
+};
+
+const char *alloc_subsystem_name(AllocSubsystem subsystem);
+
+struct AllocCounts {
+  uint64_t count[(size_t)AllocSubsystem::COUNT] = {};
+  uint64_t bytes[(size_t)AllocSubsystem::COUNT] = {};
+
+  inline uint64_t total() const {
+    uint64_t total = 0;
+    for (uint64_t c : this->count) total += c;
+    return total;
+  }
+};
+
+namespace alloc_stats {
+#ifdef FRC_PATHGEN_ALLOC_STATS
+constexpr bool enabled = true;
+
+// must run before SDL_Init, SDL can't switch allocators with memory outstanding
+void install_sdl_hooks();
+// must run before ImGui::CreateContext, ImGui frees everything with the allocator it allocated with
+void install_imgui_hooks();
+// counts since the last call, then starts over
+AllocCounts take();
+#else
+constexpr bool enabled = false;
+
+inline void install_sdl_hooks() {}
+inline void install_imgui_hooks() {}
+inline AllocCounts take() { return {}; }
+#endif
+}
+
+class AllocScope {
+public:
+#ifdef FRC_PATHGEN_ALLOC_STATS
+  AllocScope(AllocSubsystem subsystem);
+  ~AllocScope();
+
+  AllocScope(const AllocScope &) = delete;
+  AllocScope &operator=(const AllocScope &) = delete;
+private:
+  AllocSubsystem previous;
+#else
+  inline AllocScope(AllocSubsystem) {}
+#endif
+};
+}
@@ -10,11 +10,28 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include "alloc_stats.hpp"
+#include "edit_history.hpp"
 #include "camera_controller.hpp"
+#include "field_map.hpp"
+#include "frame_arena.hpp"
+#include "gfx.hpp"
+#include "multi_robot.hpp"
 #include "robot.hpp"
+#include "pose_estimator.hpp"
+#include "sensors.hpp"
 #include "path_follower.hpp"
 #include "path.hpp"
+#include "path_optimizer.hpp"
+#include "path_preview.hpp"
+#include "project_file.hpp"
+#include "robot_log_overlay.hpp"
+#include "routine.hpp"
+#include "trajectory_cache.hpp"
 #include <imgui.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
 
 namespace frc_pathgen {
 
@@ -27,17 +44,96 @@ public:
   void run();
 private:
   void teardown();
+  void init_deferred();
+  void log_startup_phase(const char *name);
+  // counts the frame's allocations (FRC_PATHGEN_ALLOC_STATS builds) and resets the arena
+  void end_frame();
+  void draw_alloc_stats();
+  // reshapes `path` around the defender, then recompiles the routine
+  void draw_optimizer();
+  // runs the optimizer on a copy of `path` on optimizer_worker, poll_optimizer() takes the
+  // result back on the UI thread once it's done
+  void start_optimizer();
+  void poll_optimizer();
+  // ctrl+z, ctrl+y / ctrl+shift+z
+  bool consume_history_event(SDL_Event &e);
+  // `path` and the routine from the current history state
+  void load_history_state();
+  void recompile_routine();
+  // lists project.frcproj from the data directory, runs a path or routine when it's clicked
+  void draw_project();
+  void run_project_routine(Routine routine, const TrajectoryConfig &config, float dt);
 
   SDL_Window *window;
   SDL_Renderer *renderer;
-  TTF_Font *grid_font;
-  TTF_Font *fps_font;
   ImFont *ui_font;
+  GlyphAtlas grid_labels;
+  GlyphAtlas fps_label;
   Viewport viewport;
 
+  FrameArena frame_arena;
+  uint64_t frame_index = 0;
+  AllocCounts frame_allocs;
+  bool alloc_reported[(size_t)AllocSubsystem::COUNT] = {};
+
   Robot robot;
+  SimulatedSensors sensors;
+  PoseEstimator pose_estimator;
   CameraController camera_controller;
   PathFollower path_follower;
   BezierPath path;
+
+  // alliance partners and a defender, `robot` shows up in there as a kinematic proxy
+  MultiRobotWorld field_robots;
+  uint32_t robot_proxy = 0;
+  uint32_t defender = 0;
+
+  // made on first use, it owns a thread pool
+  std::unique_ptr<PathOptimizer> path_optimizer;
+  // every edit to `path` lands here, `path` itself is the working copy
+  std::unique_ptr<EditHistory> history;
+  PathOptimizerResult optimizer_result;
+  bool optimizer_ran = false;
+  bool optimizer_apply_unclear = false; // keep a faster shape even if it clips the defender
+  struct OptimizerJob {
+    OptimizerJob(const BezierPath &path) : path(path) {
+      for (int i = 0; i < 4; ++i) this->start[i] = path.get_control_point(i);
+    }
+
+    std::atomic<bool> done { false };
+    Vec2 start[4];   // `path`'s control points when it started
+    BezierPath path; // the copy being optimized
+    PathOptimizerResult result;
+  };
+  std::shared_ptr<OptimizerJob> optimizer_job; // null when nothing's running
+  // after path_optimizer, so a running job joins before the optimizer it uses goes away
+  std::unique_ptr<ThreadPool> optimizer_worker;
+
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point startup_begin;
+  Clock::time_point phase_begin;
+  bool initialized = false; // init_deferred() has run
+  std::filesystem::path data_dir;
+
+  std::unique_ptr<FieldMap> field_map;
+  // a real robot's log over the simulation
+  std::unique_ptr<RobotLogOverlay> robot_log;
+
+  std::unique_ptr<TrajectoryCache> trajectory_cache;
+  // paths are only parsed once they're clicked
+  std::unique_ptr<ProjectFile> project;
+  // after `project`, whose paths it points at while drawing them
+  std::unique_ptr<PathPreviews> path_previews;
+  // each project path's preview source and key, built the first time its row is on screen
+  struct PreviewRow {
+    bool built = false, loaded = false; // loaded: the path parsed
+    uint64_t key = 0;
+    PathPreviewSource source;
+  };
+  std::vector<PreviewRow> preview_rows;
+  std::string project_error;
+  Routine project_routine;
+  Routine routine;
+  CompiledRoutine compiled_routine;
 };
 }
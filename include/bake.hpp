@@ -0,0 +1,22 @@
+/*
+* frc-pathgen/include/bake.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+namespace frc_pathgen {
+
+// Generates each .path file and writes them all into one C++ header as
+//   inline constexpr frc_pathgen::BakedSample <name>[] = { ... };
+// (see baked_trajectory.hpp), each followed by a static_assert that the rows stay inside
+// the file's velocity/acceleration limits. The header is only rewritten when it changes,
+// so it does not trigger rebuilds. Returns a process exit code.
+int run_bake(const std::filesystem::path &header, const std::vector<std::filesystem::path> &inputs);
+}
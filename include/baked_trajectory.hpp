@@ -0,0 +1,194 @@
+/*
+* frc-pathgen/include/baked_trajectory.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "curves.hpp"
+#include <cstddef>
+
+// Trajectories generated entirely at compile time, for robot code that wants fixed autos
+// with no runtime generation and no file IO. Two ways in:
+//  - headers written by `frc-pathgen --bake` (or frc_pathgen_bake() in CMake), which hold
+//    plain BakedSample arrays plus static_asserts on the limits
+//  - bake_beziers<CAPACITY>(...) right in the source, which runs the same forward/backward
+//    profile as Trajectory in a constant expression
+// Nothing here allocates, but it isn't standalone: it needs curves.hpp, vec2.hpp and simd.hpp
+// (which pulls in <experimental/simd> where there is one), so a robot project takes all four.
+// A BakedTrajectory holds its CAPACITY rows inline, keep big ones static or constexpr rather
+// than on the stack, and pass them by reference.
+
+namespace frc_pathgen {
+
+struct BakedSample {
+  float time;
+  float x, y;
+  float vx, vy;
+  float heading = 0.0f, omega = 0.0f; // bake_beziers() doesn't turn, --bake carries the .path's headings
+};
+
+struct BakeLimits {
+  float max_velocity;      // m/s
+  float max_acceleration;  // m/s^2
+  float curvature_margin = 0.9f;
+};
+
+struct BakedBezier {
+  Vec2 p0, p1, p2, p3;
+};
+
+template<size_t CAPACITY>
+struct BakedTrajectory {
+  BakedSample rows[CAPACITY] = {};
+  size_t count = 0;
+  float dt = 0.0f;
+  bool overflow = false; // CAPACITY was too small, the tail is missing
+
+  constexpr float duration() const { return this->count? this->rows[this->count - 1].time : 0.0f; }
+};
+
+// true when no row is faster than max_velocity or changes speed faster than max_acceleration
+constexpr bool baked_within_limits(const BakedSample *rows, size_t count, float max_velocity, float max_acceleration) {
+  float last_speed = 0.0f;
+  for (size_t i = 0; i < count; ++i) {
+    float speed = constexpr_sqrt(rows[i].vx * rows[i].vx + rows[i].vy * rows[i].vy);
+    if (speed > max_velocity * 1.001f + 1e-3f) return false;
+
+    if (i > 0) {
+      float span = rows[i].time - rows[i-1].time;
+      float accel = span > 1e-4f? (speed - last_speed) / span : 0.0f;
+      if (accel < 0.0f) accel = -accel;
+      if (accel > max_acceleration * 1.05f + 1e-2f) return false;
+    }
+    last_speed = speed;
+  }
+  return true;
+}
+
+template<size_t N>
+constexpr bool baked_within_limits(const BakedSample (&rows)[N], float max_velocity, float max_acceleration) {
+  return baked_within_limits(rows, N, max_velocity, max_acceleration);
+}
+
+// what's left of max_acceleration along the path at v once the centripetal share k v^2 is
+// taken off, Trajectory::acceleration_limit() without heading changes
+constexpr float baked_acceleration_limit(float kappa0, float kappa1, float v, float max_acceleration) {
+  float k0 = kappa0 < 0.0f? -kappa0 : kappa0, k1 = kappa1 < 0.0f? -kappa1 : kappa1;
+  float k = k0 > k1? k0 : k1;
+  float left = max_acceleration - k * v * v;
+  return left > 0.0f? left : 0.0f;
+}
+
+// Profiles a chain of cubic Beziers at KNOTS knots per segment and samples it every dt seconds.
+template<size_t CAPACITY, size_t KNOTS = 64, size_t SEGMENTS>
+constexpr BakedTrajectory<CAPACITY> bake_beziers(const BakedBezier (&segments)[SEGMENTS], BakeLimits limits, float dt = 0.02f) {
+  constexpr size_t n = SEGMENTS * KNOTS + 1;
+
+  Vec2 position[n] = {};
+  Vec2 tangent[n] = {};
+  float kappa[n] = {};
+  float vlimit[n] = {};
+  float velocity[n] = {};
+  float ds[n] = {};
+  float interval[n] = {};
+
+  for (size_t k = 0; k < SEGMENTS; ++k) {
+    const BakedBezier &b = segments[k];
+    for (size_t j = 0; j <= KNOTS; ++j) {
+      size_t i = k * KNOTS + j;
+      float t = (float)j / (float)KNOTS;
+
+      Vec2 d = bezier_velocity(b.p0, b.p1, b.p2, b.p3, t);
+      Vec2 dd = bezier_acceleration(b.p0, b.p1, b.p2, b.p3, t);
+      float speed = constexpr_sqrt(Vec2::dot(d, d));
+      float curvature = speed > 1e-6f? Vec2::cross(d, dd) / (speed * speed * speed) : 0.0f;
+
+      // shared knot between two segments, keep the sharper side
+      bool shared = j == 0 && k > 0;
+      float abs_new = curvature < 0.0f? -curvature : curvature;
+      float abs_old = kappa[i] < 0.0f? -kappa[i] : kappa[i];
+      if (!shared || abs_new > abs_old) kappa[i] = curvature;
+      if (!shared || speed > 1e-6f) tangent[i] = speed > 1e-6f? d / speed : Vec2 { 0,0 };
+
+      position[i] = bezier_position(b.p0, b.p1, b.p2, b.p3, t);
+    }
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    float abs_kappa = kappa[i] < 0.0f? -kappa[i] : kappa[i];
+    float vmax = limits.curvature_margin * constexpr_sqrt(limits.max_acceleration / (abs_kappa > 1e-4f? abs_kappa : 1e-4f));
+    vlimit[i] = (i == 0 || i == n - 1)? 0.0f : (vmax < limits.max_velocity? vmax : limits.max_velocity);
+    if (i + 1 < n) ds[i] = constexpr_sqrt(Vec2::dot(position[i+1] - position[i], position[i+1] - position[i]));
+  }
+
+  // forward, then backward
+  for (size_t i = 0; i < n; ++i) {
+    float v = vlimit[i];
+    if (i > 0) {
+      float u = velocity[i-1];
+      float reach = constexpr_sqrt(u * u + 2.0f * baked_acceleration_limit(kappa[i-1], kappa[i], u, limits.max_acceleration) * ds[i-1]);
+      if (reach < v) v = reach;
+    }
+    velocity[i] = v;
+  }
+  for (size_t i = n - 1; i-- > 0;) {
+    float u = velocity[i+1];
+    float reach = constexpr_sqrt(u * u + 2.0f * baked_acceleration_limit(kappa[i], kappa[i+1], u, limits.max_acceleration) * ds[i]);
+    if (reach < velocity[i]) velocity[i] = reach;
+  }
+
+  double total = 0.0;
+  for (size_t i = 0; i + 1 < n; ++i) {
+    float vsum = velocity[i] + velocity[i+1];
+    interval[i] = vsum > 1e-6f? 2.0f * ds[i] / vsum : 0.0f;
+    total += interval[i];
+  }
+
+  BakedTrajectory<CAPACITY> out;
+  out.dt = dt;
+
+  size_t i = 0;
+  double start = 0.0;
+  for (size_t m = 0; ; ++m) {
+    bool last = (double)m * dt >= total;
+    float time = last? (float)total : (float)m * dt;
+
+    while (i + 2 < n && start + interval[i] < time) {
+      start += interval[i];
+      ++i;
+    }
+
+    float v0 = velocity[i], v1 = velocity[i+1];
+    float a = interval[i] > 0.0f? (v1 - v0) / interval[i] : 0.0f;
+    float tau = time - (float)start;
+    if (tau < 0.0f) tau = 0.0f;
+    if (tau > interval[i]) tau = interval[i];
+    float s = v0 * tau + 0.5f * a * tau * tau;
+    float frac = ds[i] > 0.0f? s / ds[i] : 0.0f;
+    if (frac > 1.0f) frac = 1.0f;
+
+    size_t k = i / KNOTS;
+    float t = ((float)(i - k * KNOTS) + frac) / (float)KNOTS;
+    const BakedBezier &b = segments[k];
+    Vec2 p = bezier_position(b.p0, b.p1, b.p2, b.p3, t);
+
+    Vec2 dir = tangent[i] * (1.0f - frac) + tangent[i+1] * frac;
+    float len = constexpr_sqrt(Vec2::dot(dir, dir));
+    Vec2 v = len > 1e-9f? dir * ((v0 + a * tau) / len) : Vec2 { 0,0 };
+
+    if (out.count == CAPACITY) {
+      out.overflow = true;
+      break;
+    }
+    out.rows[out.count++] = BakedSample { time, p.x, p.y, v.x, v.y };
+
+    if (last) break;
+  }
+
+  return out;
+}
+}
@@ -0,0 +1,26 @@
+/*
+* frc-pathgen/include/batch.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <filesystem>
+
+namespace frc_pathgen {
+
+struct BatchOptions {
+  std::filesystem::path input;  // directory of .path files
+  std::filesystem::path output; // where the .csv tables go, defaults to the input directory
+  unsigned int threads = 0;     // 0 = all cores
+  bool use_cache = true;
+};
+
+// Generates every .path file in the input directory on a thread pool, without any
+// of the SDL/ImGui setup. Prints one line per path as it finishes, then a summary.
+// Returns a process exit code.
+int run_batch(const BatchOptions &options);
+}
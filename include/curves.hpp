@@ -0,0 +1,105 @@
+/*
+* frc-pathgen/include/curves.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "vec2.hpp"
+
+// Curve math as free constexpr functions, so the same formulas serve the Path classes at
+// runtime and baked trajectories at compile time. No SDL in here, robot code can include it.
+
+namespace frc_pathgen {
+
+// Newton's method, only for constant evaluation (use std::sqrt at runtime)
+constexpr float constexpr_sqrt(float x) {
+  if (!(x > 0.0f)) return 0.0f;
+
+  double r = x > 1.0f? (double)x : 1.0;
+  for (int i = 0; i < 64; ++i) {
+    double next = 0.5 * (r + x / r);
+    if (next == r) break;
+    r = next;
+  }
+  return (float)r;
+}
+
+template<typename S>
+constexpr Vec2T<S> bezier_position(const Vec2 &p0, const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, S t) {
+  S u = S(1.0f) - t;
+  return vec2_cast<S>(p0) * (u*u*u) + vec2_cast<S>(p1) * (S(3.0f)*u*u*t)
+       + vec2_cast<S>(p2) * (S(3.0f)*u*t*t) + vec2_cast<S>(p3) * (t*t*t);
+}
+
+// d/dt
+template<typename S>
+constexpr Vec2T<S> bezier_velocity(const Vec2 &p0, const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, S t) {
+  S u = S(1.0f) - t;
+  return vec2_cast<S>(p1 - p0) * (S(3.0f)*u*u) + vec2_cast<S>(p2 - p1) * (S(6.0f)*u*t)
+       + vec2_cast<S>(p3 - p2) * (S(3.0f)*t*t);
+}
+
+// d^2/dt^2
+template<typename S>
+constexpr Vec2T<S> bezier_acceleration(const Vec2 &p0, const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, S t) {
+  S u = S(1.0f) - t;
+  return vec2_cast<S>(p2 - p1 * 2.0f + p0) * (S(6.0f)*u) + vec2_cast<S>(p3 - p2 * 2.0f + p1) * (S(6.0f)*t);
+}
+
+// straight line, eased in and out with smoothstep
+template<typename S>
+constexpr Vec2T<S> line_position(const Vec2 &a, const Vec2 &b, S t) {
+  S s = t*t*(S(3.0f) - S(2.0f)*t);
+  return vec2_cast<S>(b - a) * s + vec2_cast<S>(a);
+}
+
+template<typename S>
+constexpr Vec2T<S> line_velocity(const Vec2 &a, const Vec2 &b, S t) {
+  return vec2_cast<S>(b - a) * (S(6.0f)*t*(S(1.0f) - t));
+}
+
+template<typename S>
+constexpr Vec2T<S> line_acceleration(const Vec2 &a, const Vec2 &b, S t) {
+  return vec2_cast<S>(b - a) * (S(6.0f) - S(12.0f)*t);
+}
+
+// quintic Hermite, endpoints p with first (v) and second (a) derivatives in t.
+// neighbours that agree on p, v and a join with continuous curvature
+template<typename S>
+constexpr Vec2T<S> hermite5_position(const Vec2 &p0, const Vec2 &v0, const Vec2 &a0,
+                                     const Vec2 &p1, const Vec2 &v1, const Vec2 &a1, S t) {
+  S t2 = t*t, t3 = t2*t, t4 = t3*t, t5 = t4*t;
+  return vec2_cast<S>(p0) * (S(1.0f) - S(10.0f)*t3 + S(15.0f)*t4 - S(6.0f)*t5)
+       + vec2_cast<S>(v0) * (t - S(6.0f)*t3 + S(8.0f)*t4 - S(3.0f)*t5)
+       + vec2_cast<S>(a0) * (S(0.5f)*t2 - S(1.5f)*t3 + S(1.5f)*t4 - S(0.5f)*t5)
+       + vec2_cast<S>(a1) * (S(0.5f)*t3 - t4 + S(0.5f)*t5)
+       + vec2_cast<S>(v1) * (S(-4.0f)*t3 + S(7.0f)*t4 - S(3.0f)*t5)
+       + vec2_cast<S>(p1) * (S(10.0f)*t3 - S(15.0f)*t4 + S(6.0f)*t5);
+}
+
+template<typename S>
+constexpr Vec2T<S> hermite5_velocity(const Vec2 &p0, const Vec2 &v0, const Vec2 &a0,
+                                     const Vec2 &p1, const Vec2 &v1, const Vec2 &a1, S t) {
+  S t2 = t*t, t3 = t2*t, t4 = t3*t;
+  return vec2_cast<S>(p1 - p0) * (S(30.0f)*t2 - S(60.0f)*t3 + S(30.0f)*t4)
+       + vec2_cast<S>(v0) * (S(1.0f) - S(18.0f)*t2 + S(32.0f)*t3 - S(15.0f)*t4)
+       + vec2_cast<S>(a0) * (t - S(4.5f)*t2 + S(6.0f)*t3 - S(2.5f)*t4)
+       + vec2_cast<S>(a1) * (S(1.5f)*t2 - S(4.0f)*t3 + S(2.5f)*t4)
+       + vec2_cast<S>(v1) * (S(-12.0f)*t2 + S(28.0f)*t3 - S(15.0f)*t4);
+}
+
+template<typename S>
+constexpr Vec2T<S> hermite5_acceleration(const Vec2 &p0, const Vec2 &v0, const Vec2 &a0,
+                                         const Vec2 &p1, const Vec2 &v1, const Vec2 &a1, S t) {
+  S t2 = t*t, t3 = t2*t;
+  return vec2_cast<S>(p1 - p0) * (S(60.0f)*t - S(180.0f)*t2 + S(120.0f)*t3)
+       + vec2_cast<S>(v0) * (S(-36.0f)*t + S(96.0f)*t2 - S(60.0f)*t3)
+       + vec2_cast<S>(a0) * (S(1.0f) - S(9.0f)*t + S(18.0f)*t2 - S(10.0f)*t3)
+       + vec2_cast<S>(a1) * (S(3.0f)*t - S(12.0f)*t2 + S(10.0f)*t3)
+       + vec2_cast<S>(v1) * (S(-24.0f)*t + S(84.0f)*t2 - S(60.0f)*t3);
+}
+}
@@ -0,0 +1,90 @@
+/*
+* frc-pathgen/include/edit_history.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "path.hpp"
+#include "persistent_vector.hpp"
+#include "routine.hpp"
+#include "trajectory.hpp"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace frc_pathgen {
+
+// one path of a project and what's derived from its geometry. entries are immutable,
+// an edit makes a new one, so states that didn't touch this path keep sharing it
+struct PathEntry {
+  std::string name;
+  std::shared_ptr<const Path> path;
+  uint64_t geometry_hash = 0;
+  std::shared_ptr<const TrajectoryTable> profile; // the path on its own, rest to rest
+};
+
+PathEntry make_path_entry(std::string name, std::shared_ptr<const Path> path, const TrajectoryConfig &config, float dt = 0.02f);
+
+// a routine step that names its path by index, so it stays valid across states
+struct ProjectStep {
+  RoutineStep::Kind kind = RoutineStep::PATH;
+  uint32_t path = 0;         // PATH
+  Joint joint = Joint::STOP; // PATH
+  float wait_seconds = 0.0f; // WAIT
+};
+
+// One version of a whole project. Copying one is O(1), every with_*() edit returns a new
+// version that copies the changed entry and O(log n) trie nodes and shares everything else.
+struct ProjectState {
+  TrajectoryConfig config;
+  float dt = 0.02f;
+  // by pointer, so a trie leaf copied by an edit is 32 pointers rather than 32 entries
+  PersistentVector<std::shared_ptr<const PathEntry>> paths;
+  PersistentVector<ProjectStep> steps;
+
+  ProjectState with_path(size_t index, std::shared_ptr<const Path> path) const;
+  ProjectState with_added_path(std::string name, std::shared_ptr<const Path> path) const;
+  ProjectState with_step(size_t index, ProjectStep step) const;
+  ProjectState with_added_step(ProjectStep step) const;
+
+  // the steps as a Routine, its paths live as long as this state does
+  Routine routine() const;
+};
+
+// Linear undo/redo over project states. Every state is a handful of root pointers into
+// the shared tries, so undo and redo only move a cursor, and each commit costs memory in
+// proportion to what the edit changed. max_depth drops the oldest states (0 keeps all).
+class EditHistory {
+public:
+  EditHistory(ProjectState initial, size_t max_depth = 0);
+
+  inline const ProjectState &current() const { return this->states[this->cursor].state; }
+
+  // drops anything that could have been redone
+  void commit(ProjectState next, std::string label);
+  bool undo();
+  bool redo();
+
+  inline bool can_undo() const { return this->cursor > 0; }
+  inline bool can_redo() const { return this->cursor + 1 < this->states.size(); }
+  // what undo()/redo() would revert/reapply, empty if nothing
+  const std::string &undo_label() const;
+  const std::string &redo_label() const;
+
+  inline size_t depth() const { return this->states.size(); }
+private:
+  struct Entry {
+    ProjectState state;
+    std::string label; // the edit that made this state
+  };
+
+  std::deque<Entry> states;
+  size_t cursor = 0;
+  size_t max_depth;
+};
+}
@@ -0,0 +1,96 @@
+/*
+* frc-pathgen/include/field_map.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include "vec2.hpp"
+#include "viewport.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace frc_pathgen {
+
+struct FieldMapOptions {
+  std::filesystem::path image;     // BMP of the whole field, any resolution
+  std::filesystem::path cache_dir; // owned by the field map, pyramids of old images get deleted
+  Vec2 origin = { 0,0 };           // world position of the image's bottom left corner (m)
+  Vec2 size = { 17.548f, 8.052f }; // world size the whole image covers (m)
+  size_t max_textures = 256;       // resident tiles, 256 KiB of texture each
+  int uploads_per_frame = 4;       // texture uploads per draw(), keeps frame times flat
+};
+
+// Field drawing behind the world view, at any zoom, without holding the full image.
+// The image is cut once into 256 px tiles at every power-of-two level (on the worker
+// thread, cached on disk by file identity). Each draw() picks the level that gives about
+// one image pixel per screen pixel, draws the resident visible tiles, fills the holes
+// with a coarser tile that is resident, and queues the missing ones for the worker.
+// Textures beyond max_textures are evicted least recently drawn first.
+class FieldMap {
+public:
+  FieldMap(FieldMapOptions options);
+  ~FieldMap();
+
+  FieldMap(const FieldMap &) = delete;
+  FieldMap &operator=(const FieldMap &) = delete;
+
+  void draw(SDL_Renderer *r, const Viewport &viewport);
+
+  inline bool is_ready() const { return this->ready.load(std::memory_order_acquire); }
+  inline size_t resident_count() const { return this->resident.size(); }
+private:
+  struct Tile {
+    SDL_Texture *texture; // nullptr when the tile file could not be loaded
+    uint64_t last_drawn;
+  };
+
+  struct Loaded {
+    uint64_t key;
+    SDL_Surface *surface;
+  };
+
+  void work();
+  bool build_pyramid();
+  bool read_pyramid();
+  std::filesystem::path tile_path(int level, int x, int y) const;
+
+  void upload(SDL_Renderer *r);
+  // draws `key`, or the part of the closest resident ancestor covering it
+  bool draw_tile(SDL_Renderer *r, int level, int x, int y, const SDL_Rect &dst);
+  void evict();
+
+  FieldMapOptions options;
+  std::filesystem::path directory; // this image's pyramid
+
+  // written by the worker before `ready` is set
+  int image_width = 0, image_height = 0, levels = 0;
+  std::atomic<bool> ready = false;
+
+  // main thread only
+  std::unordered_map<uint64_t, Tile> resident;
+  std::vector<uint64_t> wanted;
+  std::vector<Loaded> arrived;
+  std::vector<std::pair<uint64_t, uint64_t>> eviction_order;
+  uint64_t frame = 0;
+
+  // shared with the worker
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::vector<uint64_t> queue; // back is taken first
+  std::vector<Loaded> loaded;
+  uint64_t loading = UINT64_MAX;
+  bool stopping = false;
+  std::thread worker;
+};
+}
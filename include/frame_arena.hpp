@@ -0,0 +1,83 @@
+/*
+* frc-pathgen/include/frame_arena.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+namespace frc_pathgen {
+
+// Bump allocator for things that only live until the end of the frame (labels, vertex
+// lists). One heap block up front, reset() just rewinds it, so steady state never touches
+// the heap. When the block runs out allocations fail instead of growing, and the
+// overflow counter says the capacity needs raising.
+class FrameArena {
+public:
+  FrameArena(size_t capacity = 64 * 1024) : buffer(new char[capacity]), capacity(capacity) {}
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  // nullptr when full
+  void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    size_t start = (this->used + align - 1) & ~(align - 1);
+    if (start + size > this->capacity) {
+      ++this->overflows;
+      return nullptr;
+    }
+    this->used = start + size;
+    this->high_water = std::max(this->high_water, this->used);
+    return this->buffer.get() + start;
+  }
+
+  // nothing in here gets destructed, so only trivial types
+  template<typename T>
+  T *allocate_array(size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+    return static_cast<T *>(this->allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  // null terminated, valid until reset(), truncated if the arena is nearly full
+  template<typename... Args>
+  std::string_view format(fmt::format_string<Args...> format, Args &&...args) {
+    size_t room = this->capacity - this->used;
+    if (room == 0) {
+      ++this->overflows;
+      return {};
+    }
+
+    char *out = this->buffer.get() + this->used;
+    auto result = fmt::format_to_n(out, room - 1, format, std::forward<Args>(args)...);
+    size_t length = std::min(result.size, room - 1);
+    if (result.size > length) ++this->overflows;
+
+    out[length] = '\0';
+    this->used += length + 1;
+    this->high_water = std::max(this->high_water, this->used);
+    return std::string_view(out, length);
+  }
+
+  inline void reset() { this->used = 0; }
+
+  inline size_t get_capacity() const { return this->capacity; }
+  inline size_t get_used() const { return this->used; }
+  inline size_t get_high_water() const { return this->high_water; }
+  inline size_t get_overflows() const { return this->overflows; }
+private:
+  std::unique_ptr<char[]> buffer;
+  size_t capacity;
+  size_t used = 0;
+  size_t high_water = 0;
+  size_t overflows = 0;
+};
+}
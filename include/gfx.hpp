@@ -10,10 +10,36 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
-#include <string>
+#include <string_view>
 
 namespace frc_pathgen {
-void draw_text(SDL_Renderer *r, TTF_Font *font, const std::string &text, float x, float y);
+
+// Printable ASCII of one font rendered once into a single texture, so drawing a label
+// is a handful of texture copies instead of a new surface and texture every frame.
+class GlyphAtlas {
+public:
+  GlyphAtlas() = default;
+  ~GlyphAtlas();
+
+  GlyphAtlas(const GlyphAtlas &) = delete;
+  GlyphAtlas &operator=(const GlyphAtlas &) = delete;
+
+  bool build(SDL_Renderer *r, TTF_Font *font);
+  // has to happen before the renderer is destroyed
+  void clear();
+  inline bool is_ok() const { return this->texture != nullptr; }
+
+  void draw(SDL_Renderer *r, std::string_view text, float x, float y) const;
+private:
+  static const int FIRST = 32;
+  static const int LAST = 126;
+
+  SDL_Texture *texture = nullptr;
+  SDL_Rect glyphs[LAST - FIRST + 1] = {};
+  int advance[LAST - FIRST + 1] = {};
+};
+
+void draw_text(SDL_Renderer *r, const GlyphAtlas &atlas, std::string_view text, float x, float y);
 void draw_arc(SDL_Renderer *r, int cx, int cy, float radius,
               float start_angle, float end_angle, int segments = 64);
 void draw_filled_circle(SDL_Renderer *r, int cx, int cy, int radius);
@@ -0,0 +1,38 @@
+/*
+* frc-pathgen/include/hash.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+namespace frc_pathgen {
+
+// 64 bit FNV-1a, stable across runs and machines (unlike std::hash) so it can name files
+struct Hasher {
+  uint64_t state = 14695981039346656037ull;
+
+  inline void update(const void *data, size_t size) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i) {
+      this->state ^= bytes[i];
+      this->state *= 1099511628211ull;
+    }
+  }
+
+  // only for types without padding, hash struct members one at a time otherwise
+  template<typename T>
+  inline void add(const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>, "hash the members instead");
+    this->update(&value, sizeof(T));
+  }
+
+  inline uint64_t digest() const { return this->state; }
+};
+}
@@ -0,0 +1,58 @@
+/*
+* frc-pathgen/include/lru_cache.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace frc_pathgen {
+
+// Fixed-capacity map that drops the least recently used entry when full.
+// Not synchronized, wrap it in a mutex when sharing between threads.
+template<typename K, typename V>
+class LruCache {
+public:
+  LruCache(size_t capacity) : capacity(capacity) {}
+
+  // nullptr on a miss, otherwise marks the entry as most recently used
+  V *get(const K &key) {
+    auto it = this->index.find(key);
+    if (it == this->index.end()) return nullptr;
+
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return &it->second->second;
+  }
+
+  void put(const K &key, V value) {
+    auto it = this->index.find(key);
+    if (it != this->index.end()) {
+      it->second->second = std::move(value);
+      this->entries.splice(this->entries.begin(), this->entries, it->second);
+      return;
+    }
+
+    if (this->capacity == 0) return;
+    if (this->index.size() >= this->capacity) {
+      this->index.erase(this->entries.back().first);
+      this->entries.pop_back();
+    }
+
+    this->entries.emplace_front(key, std::move(value));
+    this->index[key] = this->entries.begin();
+  }
+
+  inline size_t size() const { return this->index.size(); }
+private:
+  size_t capacity;
+  std::list<std::pair<K, V>> entries; // front is most recent
+  std::unordered_map<K, typename std::list<std::pair<K, V>>::iterator> index;
+};
+}
@@ -0,0 +1,103 @@
+/*
+* frc-pathgen/include/multi_robot.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include "robot.hpp"
+#include "routine.hpp"
+#include "scheduled_controller.hpp"
+#include "vec2.hpp"
+#include "viewport.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace frc_pathgen {
+
+struct RobotContact {
+  uint32_t a, b;
+  Vec2 normal;  // from a towards b
+  float depth;  // m
+};
+
+// Every robot on the field (partners, defenders), each a square Robot::wheelbase_m wide
+// with Robot's drivetrain model. State is kept as one array per field so tick() runs
+// each stage as a flat loop over all robots.
+// Collisions: sweep-and-prune over the rotated squares' bounding boxes, along the axis they
+// are spread out more on (the sort order is kept between ticks, so re-sorting is an
+// almost-free insertion sort), then separating axis on the pairs that survive. Overlaps
+// are pushed apart and the closing velocity along the contact normal is removed, no
+// friction or spin.
+class MultiRobotWorld {
+public:
+  MultiRobotWorld();
+
+  // returns the robot's index. kinematic robots are never pushed, set_pose() moves them
+  uint32_t add_robot(Vec2 position, float heading, bool kinematic = false);
+  void clear();
+
+  void set_velocity_setpoint(uint32_t i, Vec2 velocity); // m/s
+  void set_angular_velocity_setpoint(uint32_t i, float angular_velocity); // rad/s
+  // for kinematic robots mirroring something simulated elsewhere
+  void set_pose(uint32_t i, Vec2 position, float heading, Vec2 velocity);
+
+  // drive along a routine's table, shifted by `offset` and started `start_time` in.
+  // the routine must outlive the world. nullptr goes back to the setpoints
+  void follow(uint32_t i, const CompiledRoutine *routine, Vec2 offset = { 0,0 }, float start_time = 0.0f);
+  // every follower's gains, by its speed and the table's curvature. the defaults pull back onto
+  // the table with a fixed kP on top of its velocity (kV 1)
+  void set_follower_schedules(const GainSchedule<> &position, const GainSchedule<> &heading);
+
+  void tick(float dt);
+
+  void draw(SDL_Renderer *renderer, const Viewport &viewport);
+
+  inline size_t size() const { return this->x.size(); }
+  inline Vec2 get_position(uint32_t i) const { return Vec2 { this->x[i], this->y[i] }; }
+  inline float get_heading(uint32_t i) const { return this->heading[i]; }
+  inline Vec2 get_velocity(uint32_t i) const { return Vec2 { this->vx[i], this->vy[i] }; }
+
+  // from the last tick
+  inline const std::vector<RobotContact> &get_contacts() const { return this->contacts; }
+  inline size_t get_candidate_pairs() const { return this->candidate_pairs; }
+private:
+  void follow_routines(float dt);
+  void integrate(float dt);
+  void sweep();
+  bool separating_axis(uint32_t a, uint32_t b, RobotContact &contact) const;
+  void resolve();
+
+  // pose and motion
+  std::vector<float> x, y, heading;
+  std::vector<float> vx, vy, omega;
+  // drivetrain
+  std::vector<float> vx_setpoint, vy_setpoint, omega_setpoint;
+  std::vector<float> omega_integral;
+  std::vector<float> inverse_mass; // 0 for kinematic robots
+
+  // followers, LANES robots to a controller (robot i is lane i % LANES of controller i / LANES)
+  struct Follow {
+    const CompiledRoutine *routine = nullptr;
+    Vec2 offset = { 0,0 };
+    float time = 0.0f;
+  };
+  static constexpr size_t LANES = 8;
+  std::vector<Follow> follows;
+  GainSchedule<> position_schedule, heading_schedule;
+  std::vector<ScheduledController<Vec2x8>> position_controllers;
+  std::vector<ScheduledController<floatx8>> heading_controllers;
+
+  // broad phase, `order` sorted by the bounding boxes' low edge on sweep_axis (0 x, 1 y)
+  std::vector<float> min_x, max_x, min_y, max_y;
+  std::vector<uint32_t> order;
+  int sweep_axis = 0;
+  size_t candidate_pairs = 0;
+
+  std::vector<RobotContact> contacts;
+};
+}
@@ -9,29 +9,73 @@
 #pragma once
 
 #include "vec2.hpp"
+#include "curves.hpp"
 #include "viewport.hpp"
+#include "hash.hpp"
 #include <SDL2/SDL.h>
 
 namespace frc_pathgen {
 
+// what profiling needs at one parameter value
+struct PathPoint {
+  Vec2 position;
+  Vec2 velocity; // d/dt
+  float kappa;   // signed curvature (1/m)
+};
+
 class Path {
 public:
   virtual Vec2 sample_position(float t) const = 0;
+  // out[i] = sample_position(t[i]), overridden by paths that can evaluate several lanes at once
+  virtual void sample_positions(const float *t, Vec2 *out, size_t count) const;
+  // d/dt and d^2/dt^2 by central differences, paths with closed forms override them
+  virtual Vec2 sample_velocity(float t) const;
+  virtual Vec2 sample_acceleration(float t) const;
+  // signed curvature (1/m), 0 where the path stands still
+  virtual float curvature(float t) const;
+  // position, velocity and curvature at every t[i], the trajectory's knots come from here
+  virtual void sample_derivatives(const float *t, PathPoint *out, size_t count) const;
   // max(||d^2/dt^2 position(t)||)
   virtual float max_acceleration() const = 0;
+  // feeds everything that defines the shape (and the kind of path) to the hasher
+  virtual void hash_geometry(Hasher &hasher) const = 0;
 
   virtual ~Path() = 0;
 };
 
 inline Path::~Path() = default;
 
+// batch evaluation through packed lanes, for paths with a templated evaluate<S>()
+template<typename P>
+inline void sample_positions_packed(const P &path, const float *t, Vec2 *out, size_t count) {
+  size_t i = 0;
+  for (; i + floatx8::size() <= count; i += floatx8::size()) {
+    Vec2x8 p = path.evaluate(packed_load<floatx8>(t + i));
+
+    float xs[floatx8::size()], ys[floatx8::size()];
+    packed_store(p.x, xs);
+    packed_store(p.y, ys);
+    for (size_t j = 0; j < floatx8::size(); ++j) out[i+j] = Vec2 { xs[j], ys[j] };
+  }
+  for (; i < count; ++i) out[i] = path.evaluate(t[i]);
+}
+
 // smoothstepped lerp
 class LinePath : public Path {
 public:
   inline LinePath(Vec2 a, Vec2 b) : a(a), b(b) {}
 
+  // S is float, double or a Packed lane type
+  template<typename S>
+  inline Vec2T<S> evaluate(S t) const { return line_position(this->a, this->b, t); }
+
   virtual Vec2 sample_position(float t) const override;
+  virtual void sample_positions(const float *t, Vec2 *out, size_t count) const override;
+  virtual Vec2 sample_velocity(float t) const override;
+  virtual Vec2 sample_acceleration(float t) const override;
+  virtual float curvature(float t) const override;
   virtual float max_acceleration() const override;
+  virtual void hash_geometry(Hasher &hasher) const override;
 
   void draw(SDL_Renderer *renderer, Viewport &viewport);
   bool consume_event(SDL_Event &e);
@@ -44,9 +88,21 @@ private:
 class BezierPath : public Path {
 public:
   inline BezierPath(Vec2 p0, Vec2 p1, Vec2 p2, Vec2 p3) : p0(p0), p1(p1), p2(p2), p3(p3) {}
+
+  // S is float, double or a Packed lane type
+  template<typename S>
+  inline Vec2T<S> evaluate(S t) const { return bezier_position(this->p0, this->p1, this->p2, this->p3, t); }
   
   virtual Vec2 sample_position(float t) const override;
+  virtual void sample_positions(const float *t, Vec2 *out, size_t count) const override;
+  virtual Vec2 sample_velocity(float t) const override;
+  virtual Vec2 sample_acceleration(float t) const override;
   virtual float max_acceleration() const override;
+  virtual void hash_geometry(Hasher &hasher) const override;
+
+  // 0-3, p0 and p3 are the endpoints
+  Vec2 get_control_point(int i) const;
+  void set_control_point(int i, Vec2 p);
 
   void draw(SDL_Renderer *renderer, Viewport &viewport);
   bool consume_event(SDL_Event &e);
@@ -55,4 +111,78 @@ public:
 private:
   Vec2 p0, p1, p2, p3;
 };
+
+// Quintic Hermite segment: positions, first and second derivatives (in t) at both ends.
+// Chaining segments that share end derivatives keeps curvature continuous across the
+// joints, which cubic Beziers can't.
+class QuinticHermitePath : public Path {
+public:
+  inline QuinticHermitePath(Vec2 p0, Vec2 v0, Vec2 a0, Vec2 p1, Vec2 v1, Vec2 a1)
+    : p0(p0), v0(v0), a0(a0), p1(p1), v1(v1), a1(a1) {}
+
+  // S is float, double or a Packed lane type
+  template<typename S>
+  inline Vec2T<S> evaluate(S t) const { return hermite5_position(this->p0, this->v0, this->a0, this->p1, this->v1, this->a1, t); }
+
+  virtual Vec2 sample_position(float t) const override;
+  virtual void sample_positions(const float *t, Vec2 *out, size_t count) const override;
+  virtual Vec2 sample_velocity(float t) const override;
+  virtual Vec2 sample_acceleration(float t) const override;
+  virtual float max_acceleration() const override;
+  virtual void hash_geometry(Hasher &hasher) const override;
+
+  void draw(SDL_Renderer *renderer, Viewport &viewport);
+
+  virtual ~QuinticHermitePath() override = default;
+private:
+  Vec2 p0, v0, a0, p1, v1, a1;
+};
+
+// Clothoid (Euler spiral) segment: curvature changes linearly with arc length, from
+// kappa_start to kappa_end over `length` metres, starting at `start` facing `heading` (rad).
+// t is arc length / length, so the speed in t is constant and the curvature, heading and
+// arc length are exact. Position is the Fresnel integral of the heading, summed once per
+// panel at construction and finished per sample with 5-point Gauss-Legendre, panels are
+// kept short enough in turning for that to be exact to float precision. That holds up to
+// MAX_TURNING, past it the panels get longer (the constructor warns) and .path files refuse it.
+class ClothoidPath : public Path {
+public:
+  static constexpr int MAX_PANELS = 64;
+  // a panel turns at most this much (rad), where 5-point Gauss-Legendre is exact to float precision
+  static constexpr float PANEL_TURN = 0.25f;
+  // the most max(|kappa_start|, |kappa_end|) * length that fits in MAX_PANELS
+  static constexpr float MAX_TURNING = MAX_PANELS * PANEL_TURN;
+
+  ClothoidPath(Vec2 start, float heading, float length, float kappa_start, float kappa_end);
+
+  virtual Vec2 sample_position(float t) const override;
+  virtual Vec2 sample_velocity(float t) const override;
+  virtual Vec2 sample_acceleration(float t) const override;
+  virtual float curvature(float t) const override;
+  virtual float max_acceleration() const override;
+  virtual void hash_geometry(Hasher &hasher) const override;
+
+  inline float get_length() const { return this->length; }
+  inline float heading_at(float t) const {
+    float s = t * this->length;
+    return this->heading + this->kappa_start * s + 0.5f * this->sharpness * s * s;
+  }
+  inline Vec2 end_position() const { return this->sample_position(1.0f); }
+  inline float end_heading() const { return this->heading_at(1.0f); }
+
+  void draw(SDL_Renderer *renderer, Viewport &viewport);
+
+  virtual ~ClothoidPath() override = default;
+private:
+  // integral of (cos, sin)(heading) over [s0, s1], s1 - s0 within one panel
+  Vec2 integrate(float s0, float s1) const;
+
+  Vec2 start;
+  float heading, length, kappa_start, kappa_end;
+  float sharpness; // dkappa/ds
+
+  int panels;
+  float panel_length;
+  Vec2 panel_start[MAX_PANELS + 1];
+};
 }
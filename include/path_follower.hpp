@@ -8,12 +8,18 @@
 
 #pragma once
 
-#include "pid.hpp"
+#include "scheduled_controller.hpp"
 #include "viewport.hpp"
 #include "vec2.hpp"
 #include "robot.hpp"
 #include "path.hpp"
+#include "pose_estimator.hpp"
+#include "routine.hpp"
+#include "telemetry.hpp"
 #include <SDL2/SDL.h>
+#include <imgui.h>
+#include <functional>
+#include <string>
 
 namespace frc_pathgen {
 
@@ -22,24 +28,59 @@ public:
   PathFollower(Robot &robot);
   
   void set_path(Path &path);
+  // follow a compiled routine's table instead of a single path, the routine must outlive the follower
+  void set_routine(const CompiledRoutine &routine);
+  void set_marker_callback(std::function<void(const std::string &)> callback);
+  // steer by the estimated pose instead of the simulator's ground truth (nullptr goes back to truth)
+  void set_pose_estimator(const PoseEstimator *estimator);
 
   void draw(SDL_Renderer *renderer, const Viewport &viewport);
 
   void tick(float dt);
-private:
+  // s since the path or routine (re)started, in both modes
+  inline float get_time() const { return this->elapsed; }
+
+  // curvature speed limit of the current path at t, updates the displayed curvature
   float calc_vmax(float t);
+private:
+  Pose measured_pose() const;
+  // from the estimator like the pose, the simulator's truth without one
+  Vec2 measured_velocity() const;
+  void tick_routine(float dt);
+  // both modes' tail: the controllers toward `target` along `gradient` at `kappa`, the
+  // robot's setpoints, and a history sample
+  void steer(Vec2 position, float heading_setpoint, float heading, float omega, float dt);
+  void record(Vec2 position, Vec2 velocity_setpoint, float angular_velocity_setpoint);
+  // the controllers' gain tables from the tuning (the feedforward slider)
+  void build_schedules();
 
-  float time = 0.0f;
+  float time = 0.0f;    // path parameter t, or s into the routine
+  float elapsed = 0.0f; // s, reset with `time`
   Path *path = nullptr;
 
+  const CompiledRoutine *routine = nullptr;
+  size_t marker_cursor = 0;
+  const std::string *last_marker = nullptr;
+  std::function<void(const std::string &)> marker_callback;
+
   float feedforward = 0.0f;
   Robot &robot;
-  PIDController<Vec2, float> position_pid;
+  const PoseEstimator *estimator = nullptr;
+  ScheduledController<Vec2> position_controller;
   Vec2 target;
   Vec2 gradient;
   float timescale = 1.0f;
   float kappa = 0.0f;
   float vtarg = 1.0f;
-  PIDController<float> angle_pid;
+  ScheduledController<float> angle_controller;
+
+  // one sample per tick for the whole run
+  TelemetryChannel speed_target { "target", IM_COL32(80, 255, 255, 255) };
+  TelemetryChannel speed { "actual", IM_COL32(255, 255, 80, 255) };
+  TelemetryChannel tracking_error { "error (m)", IM_COL32(255, 90, 90, 255) };
+  TelemetryChannel curvature { "kappa", IM_COL32(180, 130, 255, 255) };
+  TelemetryChannel position_output { "position", IM_COL32(120, 220, 120, 255) };
+  TelemetryChannel heading_output { "heading", IM_COL32(255, 150, 60, 255) };
+  TelemetryPlot speed_plot, error_plot, curvature_plot, output_plot;
 };
 }
@@ -0,0 +1,92 @@
+/*
+* frc-pathgen/include/path_io.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "path.hpp"
+#include "routine.hpp"
+#include "trajectory.hpp"
+#include <filesystem>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frc_pathgen {
+
+// past these a file (or a server request) could ask for a table too big to generate
+constexpr int MAX_SAMPLES_PER_SEGMENT = 4096;
+constexpr float MIN_DT = 1e-4f; // s
+
+// A path definition as read from a .path file, one statement per line:
+//   # comment
+//   bezier x0 y0 x1 y1 x2 y2 x3 y3
+//   line ax ay bx by
+//   hermite x0 y0 vx0 vy0 ax0 ay0 x1 y1 vx1 vy1 ax1 ay1   (quintic, derivatives in t)
+//   clothoid x y heading length kappa0 kappa1           (heading in radians, length in m, max |kappa| * length <= 16)
+//   heading u radians     (face this way at u: segment index + t, 1.5 is halfway through the second)
+//   max_velocity 3.5      (generator settings, all optional)
+//   max_acceleration 2.0
+//   max_angular_acceleration 20
+//   curvature_margin 0.9
+//   samples 64            (2 to MAX_SAMPLES_PER_SEGMENT)
+//   dt 0.02               (at least MIN_DT)
+struct PathSpec {
+  std::string name;
+  std::vector<std::unique_ptr<Path>> segments;
+  std::vector<HeadingWaypoint> headings;
+  TrajectoryConfig config;
+  float dt = 0.02f;
+
+  std::vector<const Path *> segment_pointers() const;
+  // the headings on segment k, added to the routine's latest step (which should be that segment)
+  void add_segment_headings(Routine &routine, size_t k) const;
+};
+
+inline bool is_statement_space(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+// splits a line into at most N whitespace separated tokens (views into the line), stops
+// at a '#' comment, returns how many tokens there were
+template<size_t N>
+size_t split_statement(std::string_view line, std::string_view (&tokens)[N]) {
+  size_t count = 0;
+  size_t i = 0;
+  while (i < line.size()) {
+    while (i < line.size() && is_statement_space(line[i])) ++i;
+    if (i >= line.size() || line[i] == '#') break;
+
+    size_t start = i;
+    while (i < line.size() && !is_statement_space(line[i])) ++i;
+
+    if (count < N) tokens[count] = line.substr(start, i - start);
+    ++count;
+  }
+  return count;
+}
+
+// the whole token or nothing
+bool parse_float(std::string_view token, float &out);
+
+// 1-based column of a token split out of `line`
+inline size_t column_of(std::string_view line, std::string_view token) {
+  return (size_t)(token.data() - line.data()) + 1;
+}
+
+// one line of the syntax above, blank and comment lines are fine too.
+// on failure `error` holds "line N, column C: what went wrong"
+bool parse_path_statement(std::string_view line, size_t line_number, PathSpec &spec, std::string &error);
+// on failure `error` holds "line N, column C: what went wrong"
+bool parse_path_spec(std::string_view text, PathSpec &spec, std::string &error);
+bool load_path_file(const std::filesystem::path &file, PathSpec &spec, std::string &error);
+
+// t,x,y,vx,vy,kappa,heading,omega with a header row
+void write_trajectory_csv(std::ostream &out, const TrajectoryTable &table);
+}
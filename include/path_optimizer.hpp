@@ -0,0 +1,85 @@
+/*
+* frc-pathgen/include/path_optimizer.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "path.hpp"
+#include "robot.hpp"
+#include "thread_pool.hpp"
+#include "trajectory.hpp"
+#include <vector>
+
+namespace frc_pathgen {
+
+// circular keep-out zone, the robot's own radius is added on top
+struct Obstacle {
+  Vec2 center;
+  float radius;
+};
+
+struct PathOptimizerConfig {
+  // coarser than the displayed profile, it only has to rank shapes
+  TrajectoryConfig trajectory = { 48 };
+  float time_budget = 1.0f;        // s of wall time, the best shape so far is kept when it runs out
+  int max_iterations = 200;
+  float initial_step = 0.5f;       // m, first line search step
+  float min_step = 0.002f;         // m, converged once no step this small improves anything
+  float difference_step = 0.005f;  // m, for the finite difference gradient
+  float robot_radius = Robot::frame_radius_m;
+  float obstacle_weight = 500.0f;  // s per m of intrusion, averaged over the samples
+  int obstacle_samples = 64;       // per segment
+};
+
+struct PathOptimizerResult {
+  float initial_time = 0.0f; // s, profiled with the optimizer's config
+  float final_time = 0.0f;
+  int iterations = 0;
+  int evaluations = 0;
+  double seconds = 0.0;
+  bool converged = false;    // false if the budget or the iteration cap ran out first
+  bool clear = true;         // the final shape stays out of every obstacle
+  bool applied = false;      // the chain was changed, see optimize()
+};
+
+// Moves the interior control points of a Bezier chain to minimize its profiled time.
+// Endpoints and joints are waypoints and never move. Joints that are smooth (handles
+// collinear) stay smooth: they share one handle direction with free lengths on each side,
+// so the profile's curvature limit (Robot::bot_acceleration through TrajectoryConfig) is
+// what pushes back against shortcuts. Obstacles add a penalty on sampled positions.
+// Each iteration takes a central difference gradient and then a parallel line search,
+// with all the candidate shapes profiled on the pool at once.
+class PathOptimizer {
+public:
+  // 0 = one worker per hardware thread
+  PathOptimizer(PathOptimizerConfig config = {}, unsigned int threads = 0);
+
+  inline void set_config(const PathOptimizerConfig &config) { this->config = config; }
+  inline const PathOptimizerConfig &get_config() const { return this->config; }
+  inline void set_obstacles(std::vector<Obstacle> obstacles) { this->obstacles = std::move(obstacles); }
+  inline const std::vector<Obstacle> &get_obstacles() const { return this->obstacles; }
+
+  // segments are consecutive (each starts where the last ended) and are changed in place,
+  // but only if the best shape is clear of every obstacle or `apply_unclear` asks for it anyway
+  PathOptimizerResult optimize(const std::vector<BezierPath *> &chain, bool apply_unclear = false);
+private:
+  // x <-> control points. smooth[j] is whether joint j (end of segment j) keeps its tangent
+  void extract(const std::vector<BezierPath> &chain, std::vector<float> &x) const;
+  void apply(const float *x, std::vector<BezierPath> &chain) const;
+
+  // profiled time plus the obstacle penalty, safe to call from several workers at once
+  float evaluate(const float *x, std::vector<BezierPath> &scratch, bool *clear = nullptr) const;
+
+  PathOptimizerConfig config;
+  std::vector<Obstacle> obstacles;
+  ThreadPool pool;
+
+  // per optimize() call
+  std::vector<BezierPath> base;
+  std::vector<bool> smooth;
+};
+}
@@ -0,0 +1,115 @@
+/*
+* frc-pathgen/include/path_preview.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include "path.hpp"
+#include "trajectory.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace frc_pathgen {
+
+struct PathPreviewOptions {
+  int width = 160, height = 80;          // px
+  Vec2 field_origin = { 0,0 };           // m, same as FieldMapOptions
+  Vec2 field_size = { 17.548f, 8.052f }; // m
+  int keyframes = 4;                     // robot footprints along the run, start and end included
+  unsigned int threads = 0;              // 0 = every hardware thread but the UI's
+  size_t max_textures = 512;             // resident previews, width * height * 4 bytes each
+  int uploads_per_frame = 8;             // texture uploads per begin_frame()
+};
+
+// what a preview is drawn from, the segments have to outlive any PathPreviews it's given to
+struct PathPreviewSource {
+  std::vector<const Path *> segments;
+  std::vector<HeadingWaypoint> headings;
+  TrajectoryConfig config;
+};
+
+struct PathPreviewImage {
+  int width = 0, height = 0;
+  std::vector<uint8_t> pixels; // RGBA8, top row first
+  float duration = 0.0f;       // of the profiled run, s
+};
+
+// the field outline, the path and the robot's footprint at evenly spaced times of its
+// profile, turned to the profile's heading. touches no renderer, safe on any thread
+void rasterize_path_preview(const PathPreviewSource &source, const PathPreviewOptions &options, PathPreviewImage &out);
+
+// Thumbnails for a path library, rasterized on worker threads and uploaded a few per frame.
+// Every frame: begin_frame(), get() for each preview on screen, end_frame(). A preview
+// that isn't resident yet is queued and get() returns nullptr until it arrives, and the
+// queue is replaced each frame, so previews scrolled past are never drawn. Previews are
+// keyed by the profile's trajectory_key(), paths with the same geometry and settings
+// share one, and textures beyond max_textures are evicted least recently shown first.
+class PathPreviews {
+public:
+  PathPreviews(PathPreviewOptions options = {});
+  ~PathPreviews();
+
+  PathPreviews(const PathPreviews &) = delete;
+  PathPreviews &operator=(const PathPreviews &) = delete;
+
+  void begin_frame(SDL_Renderer *r);
+  // nullptr until it's ready, `duration` is only written once it is
+  SDL_Texture *get(const PathPreviewSource &source, float *duration = nullptr);
+  // the same with the key from key_of(source) kept by the caller. a resident preview is found
+  // without hashing or copying anything, `source` is only copied when it has to be queued
+  SDL_Texture *get(uint64_t key, const PathPreviewSource &source, float *duration = nullptr);
+  void end_frame();
+
+  static uint64_t key_of(const PathPreviewSource &source);
+
+  inline const PathPreviewOptions &get_options() const { return this->options; }
+  inline size_t resident_count() const { return this->resident.size(); }
+private:
+  struct Preview {
+    SDL_Texture *texture; // nullptr if the upload failed
+    float duration;
+    uint64_t last_shown;
+  };
+
+  struct Job {
+    uint64_t key;
+    PathPreviewSource source;
+  };
+
+  struct Finished {
+    uint64_t key;
+    PathPreviewImage image;
+  };
+
+  void work();
+  void evict();
+
+  PathPreviewOptions options;
+
+  // main thread only
+  std::unordered_map<uint64_t, Preview> resident;
+  std::vector<Job> wanted;
+  std::vector<Finished> arrived;
+  std::vector<std::pair<uint64_t, uint64_t>> eviction_order;
+  uint64_t frame = 0;
+
+  // shared with the workers
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::vector<Job> queue; // back is taken first
+  std::vector<Finished> finished;
+  std::unordered_set<uint64_t> in_flight;
+  bool stopping = false;
+  std::vector<std::thread> workers;
+};
+}
@@ -0,0 +1,117 @@
+/*
+* frc-pathgen/include/persistent_vector.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace frc_pathgen {
+
+// Immutable vector as a 32-way trie of shared nodes.
+// set() and push_back() return a new vector that copies only the nodes on the way down to
+// the changed element (one leaf of up to 32 values and log32(n) interior nodes) and shares
+// the rest with the original. Copying a vector copies one pointer. Nodes are never modified
+// once shared, so versions can be read from several threads at once.
+template<typename T>
+class PersistentVector {
+public:
+  static constexpr size_t BITS = 5;
+  static constexpr size_t WIDTH = 1 << BITS;
+  static constexpr size_t MASK = WIDTH - 1;
+
+  inline size_t size() const { return this->count; }
+  inline bool empty() const { return this->count == 0; }
+
+  const T &operator[](size_t i) const {
+    const Node *node = this->root.get();
+    for (size_t shift = this->shift; shift > 0; shift -= BITS) node = node->children[(i >> shift) & MASK].get();
+    return node->values[i & MASK];
+  }
+
+  PersistentVector set(size_t i, T value) const {
+    PersistentVector out = *this;
+    out.root = set_in(*this->root, this->shift, i, std::move(value));
+    return out;
+  }
+
+  PersistentVector push_back(T value) const {
+    PersistentVector out = *this;
+    if (!this->root) {
+      out.root = push_in(nullptr, 0, 0, std::move(value));
+    } else if (this->count == (WIDTH << this->shift)) {
+      // full, grow a level on top
+      auto grown = std::make_shared<Node>();
+      grown->children.push_back(this->root);
+      grown->children.push_back(push_in(nullptr, this->shift, this->count, std::move(value)));
+      out.root = std::move(grown);
+      out.shift = this->shift + BITS;
+    } else {
+      out.root = push_in(this->root.get(), this->shift, this->count, std::move(value));
+    }
+    ++out.count;
+    return out;
+  }
+
+  // in index order, without the per-element descent of operator[]
+  template<typename F>
+  void for_each(F &&f) const {
+    if (this->root) visit(*this->root, this->shift, f);
+  }
+
+  // same version, or at least the same storage (O(1), for cheap change detection)
+  inline bool shares_root(const PersistentVector &other) const { return this->root == other.root; }
+private:
+  // interior nodes use children, leaves (shift 0) use values
+  struct Node {
+    std::vector<std::shared_ptr<const Node>> children;
+    std::vector<T> values;
+  };
+  using NodePtr = std::shared_ptr<const Node>;
+
+  static NodePtr set_in(const Node &node, size_t shift, size_t i, T &&value) {
+    auto copy = std::make_shared<Node>(node);
+    if (shift == 0) {
+      copy->values[i & MASK] = std::move(value);
+    } else {
+      size_t k = (i >> shift) & MASK;
+      copy->children[k] = set_in(*node.children[k], shift - BITS, i, std::move(value));
+    }
+    return copy;
+  }
+
+  // node is null where the path to index i doesn't exist yet
+  static NodePtr push_in(const Node *node, size_t shift, size_t i, T &&value) {
+    auto copy = node? std::make_shared<Node>(*node) : std::make_shared<Node>();
+    if (shift == 0) {
+      copy->values.push_back(std::move(value));
+      return copy;
+    }
+
+    size_t k = (i >> shift) & MASK;
+    if (k < copy->children.size()) copy->children[k] = push_in(copy->children[k].get(), shift - BITS, i, std::move(value));
+    else copy->children.push_back(push_in(nullptr, shift - BITS, i, std::move(value)));
+    return copy;
+  }
+
+  template<typename F>
+  static void visit(const Node &node, size_t shift, F &f) {
+    if (shift == 0) {
+      for (const T &value : node.values) f(value);
+      return;
+    }
+    for (const NodePtr &child : node.children) visit(*child, shift - BITS, f);
+  }
+
+  NodePtr root;
+  size_t shift = 0;
+  size_t count = 0;
+};
+}
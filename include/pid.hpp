@@ -8,6 +8,8 @@
 
 #pragma once
 
+// T is the measured quantity (float, Vec2, or a packed Vec2x4/Vec2x8 to run one controller per lane),
+// K the gain type that scales it (float, or floatx4/floatx8 for per-lane gains)
 template<typename T, typename K=T>
 struct PIDController {
   PIDController(K kP, K kI, K kD) : kP(kP), kI(kI), kD(kD) {}
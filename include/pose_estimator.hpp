@@ -0,0 +1,106 @@
+/*
+* frc-pathgen/include/pose_estimator.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "vec2.hpp"
+#include <array>
+#include <cstddef>
+
+namespace frc_pathgen {
+
+struct Pose {
+  Vec2 position = { 0,0 }; // m
+  float heading = 0.0f;    // rad, counter-clockwise from +x
+};
+
+struct PoseEstimatorConfig {
+  float odometry_stddev = 0.03f;   // wheel slip, as a fraction of the distance driven
+  float gyro_stddev = 0.01f;       // as a fraction of the rotation
+  float gyro_drift = 0.005f;       // rad/sqrt(s), uncertainty the gyro adds while sitting still
+  float outlier_gate = 11.34f;     // chi-square, 3 dof at 99%, vision further out than this is rejected
+  // after this many rejections in a row the estimate is the outlier, take the next one anyway
+  int max_consecutive_rejects = 5;
+};
+
+// Extended Kalman filter over [x, y, heading], driven by odometry and corrected by vision.
+// Everything is fixed size (no heap), so it can run at control rate in batch simulations.
+// Every predict() is kept in a ring of the last HISTORY steps. A vision measurement
+// taken `latency` ago is fused at the step it belongs to (found by binary search), and
+// the steps after it are replayed from their stored odometry and vision. Fusing costs at
+// most HISTORY predict steps, however late the measurement is; anything older than the
+// ring, or past VISION_PER_STEP in one step, is dropped.
+class PoseEstimator {
+public:
+  static constexpr size_t HISTORY = 256;
+  static constexpr size_t VISION_PER_STEP = 4;
+
+  PoseEstimator(PoseEstimatorConfig config = {});
+
+  void reset(const Pose &pose, float time, float position_stddev = 0.05f, float heading_stddev = 0.02f);
+
+  // odometry since the last call: displacement in the robot frame (x forward, y left)
+  // and the gyro's heading change
+  void predict(float time, Vec2 body_displacement, float heading_change);
+
+  // absolute pose captured at `time`, which may be in the past. false if the measurement was
+  // older than the history or failed the outlier gate
+  bool add_vision(float time, const Pose &measured, float position_stddev, float heading_stddev);
+
+  inline Pose get_pose() const { return this->latest().pose; }
+  // world frame, from the latest odometry step
+  Vec2 get_velocity() const;
+  inline float get_time() const { return this->latest().time; }
+  // 1 sigma
+  float get_position_stddev() const;
+  float get_heading_stddev() const;
+
+  inline size_t get_fused() const { return this->fused; }
+  inline size_t get_rejected() const { return this->rejected; }
+  inline size_t get_dropped() const { return this->dropped; }
+  inline size_t get_last_replay() const { return this->last_replay; }
+private:
+  using Mat3 = std::array<std::array<float, 3>, 3>;
+
+  struct Vision {
+    Pose pose;
+    float position_variance, heading_variance;
+  };
+
+  struct Step {
+    float time;
+    // odometry that led here from the previous step
+    Vec2 body_displacement;
+    float heading_change;
+    // vision fused at this step, in the order it arrived
+    std::array<Vision, VISION_PER_STEP> vision;
+    size_t vision_count;
+    // filter state after all of it
+    Pose pose;
+    Mat3 covariance;
+  };
+
+  inline Step &at(size_t i) { return this->steps[(this->first + i) % HISTORY]; }
+  inline const Step &at(size_t i) const { return this->steps[(this->first + i) % HISTORY]; }
+  inline const Step &latest() const { return this->at(this->count - 1); }
+
+  // `to` = `from` advanced by to's stored odometry
+  void propagate(const Step &from, Step &to) const;
+  // kalman update of `step` by `vision`. false if it's further out than `gate` (or S is singular)
+  bool correct(Step &step, const Vision &vision, float gate) const;
+
+  PoseEstimatorConfig config;
+
+  std::array<Step, HISTORY> steps;
+  size_t first = 0;
+  size_t count = 0;
+
+  size_t fused = 0, rejected = 0, dropped = 0, last_replay = 0;
+  int consecutive_rejects = 0;
+};
+}
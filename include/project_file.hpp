@@ -0,0 +1,137 @@
+/*
+* frc-pathgen/include/project_file.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "path_io.hpp"
+#include "routine.hpp"
+#include "trajectory.hpp"
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frc_pathgen {
+
+class TrajectoryCache;
+
+// A .frcproj file: many named paths, routines over them and the robot's generator settings.
+//   frc-pathgen project 1
+//   index 3                          (written by --index, optional)
+//     robot - 0000000169 00000007 0000000029   (kind, name, byte offset, line, bytes of each block)
+//     path left 0000000198 00000010 0000000042
+//     routine two_piece 0000000240 00000013 0000000070
+//   end
+//   robot                            (.path settings, the defaults for every path)
+//     max_velocity 4.0
+//   end
+//   path left                        (any .path statements, overriding the robot block)
+//     bezier 0 0  0 6  1 3  1 5
+//   end
+//   routine two_piece
+//     path left pass                 (joint: stop, the default, or pass)
+//     marker intake 0.5              (seconds after the last step starts)
+//     wait 1.0
+//   end
+// Opening a project reads the index and nothing else, so hundreds of paths list
+// instantly. A path's geometry is parsed, and its profile generated, the first time
+// something asks for it. Without an index, or with one that no longer matches the
+// file, opening scans for the block headers instead, which still skips the geometry.
+// Each indexed block has to start and end where the index says with only blank lines
+// between, and anything after the last one (blocks added since indexing) is scanned.
+// Paths, and routines, need names of their own.
+struct ProjectBlock {
+  enum Kind { ROBOT, PATH, ROUTINE } kind;
+  std::string_view name; // into the project's text
+  size_t offset;         // of the block's first line
+  size_t line;
+  size_t length;         // bytes, through the end of its `end` line
+};
+
+struct ProjectRoutine {
+  struct Step {
+    RoutineStep::Kind kind;
+    size_t path;               // PATH, index into the project's paths
+    Joint joint;               // PATH
+    float wait_seconds;        // WAIT
+  };
+  std::vector<Step> steps;
+  std::vector<RoutineMarker> markers;
+};
+
+class ProjectFile {
+public:
+  static constexpr int FORMAT_VERSION = 1;
+
+  ProjectFile() = default;
+  // blocks point into the text
+  ProjectFile(const ProjectFile &) = delete;
+  ProjectFile &operator=(const ProjectFile &) = delete;
+
+  // on failure `error` holds "line N, column C: what went wrong"
+  bool open(const std::filesystem::path &file, std::string &error);
+  bool open_text(std::string text, std::string &error);
+
+  // whether open() could use the file's index instead of scanning
+  inline bool used_index() const { return this->indexed; }
+
+  inline const std::vector<ProjectBlock> &get_paths() const { return this->paths; }
+  inline const std::vector<ProjectBlock> &get_routines() const { return this->routines; }
+  // -1 if there is none
+  int find_path(std::string_view name) const;
+
+  // parsed on first use and kept, nullptr (with `error`) if the block doesn't parse.
+  // the path's settings start out as the robot block's
+  const PathSpec *load_path(size_t index, std::string &error);
+  // the path on its own, generated (or fetched from `cache`) on first use
+  const TrajectoryTable *load_profile(size_t index, std::string &error, TrajectoryCache *cache = nullptr);
+  const ProjectRoutine *load_routine(size_t index, std::string &error);
+
+  // a path's segments become pass-through steps ending in the routine step's joint.
+  // `out` points into this project's loaded paths
+  bool build_routine(size_t index, Routine &out, std::string &error);
+
+  inline const TrajectoryConfig &get_config() const { return this->robot.config; }
+  inline float get_dt() const { return this->robot.dt; }
+
+  // the same file with a fresh index, everything after the old index kept byte for byte
+  std::string indexed_text() const;
+private:
+  // everything open_text() does after taking the text, clear() undoes it on failure
+  bool read_blocks(std::string &error);
+  void clear();
+  bool read_header(std::string &error);
+  bool read_index(size_t &body, size_t &body_line);
+  bool scan_blocks(size_t body, size_t body_line, std::string &error);
+  bool check_names(std::string &error) const;
+  bool load_robot(std::string &error);
+  // calls statement(line, line_number) for every line of the block after its header until
+  // `end`, which must be there
+  template<typename F>
+  bool for_each_statement(const ProjectBlock &block, std::string &error, F &&statement) const;
+
+  std::string text;
+  bool indexed = false;
+  size_t body_offset = 0; // first byte after the header and index
+  size_t body_line = 1;
+
+  bool has_robot = false;
+  ProjectBlock robot_block = {};
+  PathSpec robot;
+
+  std::vector<ProjectBlock> paths;
+  std::vector<ProjectBlock> routines;
+  std::vector<std::unique_ptr<PathSpec>> loaded_paths;
+  std::vector<std::unique_ptr<TrajectoryTable>> loaded_profiles;
+  std::vector<std::unique_ptr<ProjectRoutine>> loaded_routines;
+};
+
+// rewrites a project in place with a fresh index, returns a process exit code
+int run_index(const std::filesystem::path &file);
+}
@@ -0,0 +1,20 @@
+/*
+* frc-pathgen/include/resources.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <cstddef>
+
+// Files from resources/ compiled into the binary (see embed.cmake), so the executable
+// runs from anywhere without a resources directory next to it.
+
+namespace frc_pathgen::resources {
+
+extern const unsigned char jetbrains_mono_ttf[];
+extern const size_t jetbrains_mono_ttf_size;
+}
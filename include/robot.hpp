@@ -13,6 +13,8 @@
 #include "vec2.hpp"
 #include "viewport.hpp"
 #include "pid.hpp"
+#include "telemetry.hpp"
+#include <imgui.h>
 
 namespace frc_pathgen {
 
@@ -36,6 +38,9 @@ public:
   inline Vec2 get_velocity() const {
     return this->velocity;
   }
+  inline float get_angular_velocity() const {
+    return this->angular_velocity;
+  }
 
   void draw(SDL_Renderer *renderer, const Viewport &viewport);
 
@@ -59,6 +64,13 @@ private:
 
   bool enable_keyboard_control = false;
 
+  // one sample per tick for the whole run
+  TelemetryChannel speed_setpoint_history { "setpoint", IM_COL32(80, 255, 255, 255) };
+  TelemetryChannel speed_history { "actual", IM_COL32(255, 255, 80, 255) };
+  TelemetryChannel drive_output_history { "drive", IM_COL32(255, 80, 255, 255) };
+  TelemetryChannel turn_output_history { "turn", IM_COL32(255, 150, 60, 255) };
+  TelemetryPlot speed_plot, output_plot;
+
   // applies the given motor voltages (-12v-12v)
   void apply_voltages(Vec2 xy_voltage, float angular_voltage, float dt);
 public:
@@ -74,6 +86,7 @@ public:
   static constexpr float wheel_radius_m = wheel_radius / 100.0f; // m
   static constexpr float wheel_dist_m   = wheel_dist / 100.0f;   // m
   static constexpr float wheelbase_m    = wheelbase  / 100.0f;   // m
+  static constexpr float frame_radius_m = wheelbase_m * 0.7072f; // m, center to a frame corner (half the diagonal, rounded up)
 
   static constexpr float wheel_ground_force = wheel_torque_m / wheel_radius_m; // N
   static constexpr float wheel_ground_torque = wheel_ground_force * wheel_dist_m; // Nm
@@ -0,0 +1,103 @@
+/*
+* frc-pathgen/include/robot_log.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace frc_pathgen {
+
+// a file mapped read only, for streaming through it once
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool open(const std::filesystem::path &file, std::string &error);
+
+  inline const uint8_t *data() const { return this->bytes; }
+  inline size_t size() const { return this->length; }
+
+  // done with everything before `offset`, the kernel can drop those pages, so a scan
+  // through a log of any size only keeps a few MB of it resident
+  void release_before(size_t offset);
+private:
+  const uint8_t *bytes = nullptr;
+  size_t length = 0;
+  size_t released = 0;
+};
+
+// one imported channel, compact enough to keep a whole match of it
+struct LogColumn {
+  std::string name;
+  std::vector<float> time;  // s since the start of the log, ascending
+  std::vector<float> value;
+
+  // first sample at or after t
+  size_t lower_bound(float t) const;
+  // linearly interpolated, held at the ends
+  float at(float t) const;
+};
+
+struct RobotLogOptions {
+  std::vector<std::string> channels; // names to import, empty = every numeric channel
+  float decimate_dt = 0.005f;        // s, each interval keeps only its min and max sample (0 keeps all)
+};
+
+// Telemetry from a real robot, read in one streaming pass over the mapped file.
+//  - .wpilog (WPILib DataLog): double, float, int64 and boolean entries, arrays of those
+//    (one channel per element, "name[i]"), and struct:Pose2d / Translation2d / Rotation2d /
+//    ChassisSpeeds ("name.x" "name.y" "name.rotation", "name.vx" "name.vy" "name.omega")
+//  - anything else as CSV with a header row: the column named t, time or timestamp (s) is
+//    the time, or the first column if none is, every other column is a channel
+// Only the selected channels are decoded, and each is decimated as it's read, so memory
+// goes with the log's duration and the selection, not with the file's size.
+class RobotLog {
+public:
+  bool open(const std::filesystem::path &file, const RobotLogOptions &options, std::string &error);
+  // every numeric channel in the file, without importing any of them
+  static bool list_channels(const std::filesystem::path &file, std::vector<std::string> &names, std::string &error);
+
+  inline const std::vector<LogColumn> &get_columns() const { return this->columns; }
+  // nullptr if it wasn't imported
+  const LogColumn *find(std::string_view name) const;
+
+  inline float duration() const { return this->end_time; }
+  // before decimation
+  inline uint64_t samples_read() const { return this->raw_samples; }
+private:
+  friend class LogImporter;
+
+  std::vector<LogColumn> columns;
+  float end_time = 0.0f;
+  uint64_t raw_samples = 0;
+};
+
+// Columns over a window of log time as one plot in the current ImGui window, like
+// TelemetryPlot: every pixel column is the min/max envelope of its samples.
+class RobotLogPlot {
+public:
+  static constexpr size_t MAX_COLUMNS = 2048;
+
+  // `cursor` (s) gets a vertical line if it's inside [t0, t1]
+  void draw(const char *label, const LogColumn *const *columns, const uint32_t *colors, size_t count,
+    float t0, float t1, float cursor = -1.0f, float height = 80.0f);
+private:
+  float lo[MAX_COLUMNS];
+  float hi[MAX_COLUMNS];
+  bool valid[MAX_COLUMNS];
+};
+}
@@ -0,0 +1,87 @@
+/*
+* frc-pathgen/include/robot_log_overlay.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include "robot_log.hpp"
+#include "thread_pool.hpp"
+#include "viewport.hpp"
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace frc_pathgen {
+
+// A real robot's log next to the simulation: its x/y channels as a trail in the world view
+// with a ghost of the robot at the log time, and any imported channel as a plot. The log
+// time follows the simulation (plus an offset) or is scrubbed by hand, and the simulated
+// pose is plotted over the logged one. Listing and importing run on a worker, the window
+// keeps drawing while a big log is read.
+class RobotLogOverlay {
+public:
+  RobotLogOverlay(std::filesystem::path default_file);
+
+  // `sim_time` is s since the simulated run started, the pose is the simulated robot's
+  void draw(SDL_Renderer *renderer, const Viewport &viewport, float sim_time, Vec2 sim_position, float sim_heading);
+private:
+  // a list or import on the worker, handed to the UI thread once `done` is set
+  struct Job {
+    enum Kind { LIST, IMPORT } kind;
+    std::atomic<bool> done { false };
+    bool ok = false;
+    std::string error;
+    std::vector<std::string> channels; // LIST
+    RobotLog log;                      // IMPORT
+    float ms = 0.0f;
+  };
+
+  void list();
+  void import();
+  // takes a finished job's results
+  void poll();
+  // the simulated pose at log time sim_time + offset, restarted with the run or a new offset
+  void record_sim(float sim_time, Vec2 sim_position, float sim_heading);
+  // picks x/y/heading channels by name, the first Pose2d-ish ones win
+  void guess_pose_channels();
+  void build_trail();
+  void draw_window();
+
+  char file[512];
+  std::string error;
+
+  std::vector<std::string> channels;
+  std::vector<char> selected; // per channel, vector<bool> can't hand out pointers
+  float decimate_dt = 0.005f;
+
+  RobotLog log;
+  float import_ms = 0.0f;
+  int x_column = -1, y_column = -1, heading_column = -1; // into log.get_columns()
+
+  bool follow_sim = true;
+  float offset = 0.0f; // s, log time = sim time + offset
+  float log_time = 0.0f;
+  float window = 15.0f; // s of plot around the log time
+
+  // trail in world space, strided down once on import
+  std::vector<Vec2> trail;
+  std::vector<SDL_FPoint> trail_px;
+
+  // x, y, heading in log time
+  LogColumn sim[3] = { { "sim x", {}, {} }, { "sim y", {}, {} }, { "sim heading", {}, {} } };
+  float last_sim_time = 0.0f, sim_offset = 0.0f;
+
+  RobotLogPlot pose_plot, channel_plot;
+
+  std::shared_ptr<Job> job; // null when nothing's running
+  // last, so it joins before anything a job could touch goes away
+  ThreadPool pool { 1 };
+};
+}
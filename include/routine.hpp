@@ -0,0 +1,88 @@
+/*
+* frc-pathgen/include/routine.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "path.hpp"
+#include "trajectory.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace frc_pathgen {
+
+class TrajectoryCache;
+
+// how a path hands off to whatever comes after it
+enum class Joint {
+  STOP,         // come to rest at the end of the path
+  PASS_THROUGH, // keep rolling into the next path, profiled as one chain
+};
+
+struct RoutineStep {
+  enum Kind { PATH, WAIT } kind;
+  const Path *path = nullptr;  // PATH
+  Joint joint = Joint::STOP;   // PATH
+  float wait_seconds = 0.0f;   // WAIT
+};
+
+struct RoutineMarker {
+  std::string name;
+  size_t step;  // fires `offset` seconds after this step starts
+  float offset;
+};
+
+struct RoutineHeading {
+  size_t step;   // a PATH step
+  float t;       // along that step's path
+  float heading; // radians
+};
+
+// A routine compiled into one contiguous table.
+// Markers are bucketed by the table row they fire on, so a follower only has to
+// compare its row against the previous tick's to know which ones to fire.
+struct CompiledRoutine {
+  TrajectoryTable table;
+  std::vector<float> step_start; // seconds
+
+  std::vector<std::string> marker_names; // in firing order
+  // markers firing at row i are marker_names[marker_start[i] .. marker_start[i+1])
+  std::vector<uint32_t> marker_start;
+
+  inline size_t row(float time) const {
+    if (this->table.samples.empty()) return 0;
+    size_t last = this->table.samples.size() - 1;
+    return time <= 0.0f? 0 : std::min((size_t)(time / this->table.dt), last);
+  }
+};
+
+// An autonomous routine: paths joined by stop or pass-through joints, waits, and timed markers.
+class Routine {
+public:
+  void add_path(const Path &path, Joint joint = Joint::STOP);
+  void add_wait(float seconds);
+  // relative to the start of the most recently added step
+  void add_marker(std::string name, float offset = 0.0f);
+  // face `heading` at t along the most recently added path, chains of pass-through paths
+  // turn through theirs while they drive, each chain starts facing wherever the last one ended
+  void add_heading(float t, float heading);
+
+  inline const std::vector<RoutineStep> &get_steps() const { return this->steps; }
+  inline const std::vector<RoutineMarker> &get_markers() const { return this->markers; }
+  inline const std::vector<RoutineHeading> &get_headings() const { return this->headings; }
+
+  // chains of pass-through paths are profiled (or fetched from `cache`) as one trajectory each,
+  // then everything is resampled onto a single time grid
+  CompiledRoutine compile(const TrajectoryConfig &config = {}, float dt = 0.02f, TrajectoryCache *cache = nullptr) const;
+private:
+  std::vector<RoutineStep> steps;
+  std::vector<RoutineMarker> markers;
+  std::vector<RoutineHeading> headings;
+};
+}
@@ -0,0 +1,180 @@
+/*
+* frc-pathgen/include/scheduled_controller.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "vec2.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace frc_pathgen {
+
+// PID plus feedforward: kS against friction (in the direction of the reference rate),
+// kV on the reference rate, kA on the reference acceleration. K is float, or floatx4/floatx8
+// for one set of gains per lane
+template<typename K>
+struct ControllerGainsT {
+  K kP = 0.0f, kI = 0.0f, kD = 0.0f;
+  K kS = 0.0f, kV = 0.0f, kA = 0.0f;
+};
+using ControllerGains = ControllerGainsT<float>;
+
+// Gains on a regular grid over speed [0, max_speed] and |curvature| [0, max_curvature],
+// bilinear in between and held past the edges. Fill it once (sample()), at() is two
+// clamps, two truncations and three lerps per gain, no branches or divisions.
+template<size_t SPEEDS = 6, size_t CURVATURES = 4>
+struct GainSchedule {
+  static_assert(SPEEDS >= 2 && CURVATURES >= 2, "a schedule needs two points on each axis");
+
+  float speed_scale = 1.0f;     // grid steps per m/s, (SPEEDS - 1) / max_speed
+  float curvature_scale = 1.0f; // grid steps per 1/m
+  ControllerGains gains[SPEEDS][CURVATURES] = {};
+
+  // gains_at(speed, curvature) at every grid point
+  template<typename F>
+  static GainSchedule sample(float max_speed, float max_curvature, F &&gains_at) {
+    GainSchedule s;
+    s.speed_scale = (SPEEDS - 1) / max_speed;
+    s.curvature_scale = (CURVATURES - 1) / max_curvature;
+    for (size_t i = 0; i < SPEEDS; ++i) {
+      for (size_t j = 0; j < CURVATURES; ++j) {
+        s.gains[i][j] = gains_at(max_speed * i / (SPEEDS - 1), max_curvature * j / (CURVATURES - 1));
+      }
+    }
+    return s;
+  }
+
+  // the same gains everywhere
+  static GainSchedule constant(const ControllerGains &gains) {
+    return sample(1.0f, 1.0f, [&](float, float) { return gains; });
+  }
+
+  ControllerGains at(float speed, float curvature) const {
+    float u = std::clamp(speed * this->speed_scale, 0.0f, (float)(SPEEDS - 1));
+    float v = std::clamp(std::fabs(curvature) * this->curvature_scale, 0.0f, (float)(CURVATURES - 1));
+    int i = std::min((int)u, (int)SPEEDS - 2), j = std::min((int)v, (int)CURVATURES - 2);
+    float fu = u - i, fv = v - j;
+
+    const ControllerGains (&row)[CURVATURES] = this->gains[i], (&next)[CURVATURES] = this->gains[i+1];
+    return lerp(lerp(row[j], row[j+1], fv), lerp(next[j], next[j+1], fv), fu);
+  }
+
+  // packed speeds and curvatures, a lookup per lane
+  template<typename P>
+  ControllerGainsT<P> at(const P &speed, const P &curvature) const {
+    constexpr size_t N = P::size();
+    float s[N], c[N], kP[N], kI[N], kD[N], kS[N], kV[N], kA[N];
+    packed_store(speed, s);
+    packed_store(curvature, c);
+    for (size_t l = 0; l < N; ++l) {
+      ControllerGains g = this->at(s[l], c[l]);
+      kP[l] = g.kP; kI[l] = g.kI; kD[l] = g.kD;
+      kS[l] = g.kS; kV[l] = g.kV; kA[l] = g.kA;
+    }
+    return ControllerGainsT<P> {
+      packed_load<P>(kP), packed_load<P>(kI), packed_load<P>(kD),
+      packed_load<P>(kS), packed_load<P>(kV), packed_load<P>(kA),
+    };
+  }
+
+  static inline ControllerGains lerp(const ControllerGains &a, const ControllerGains &b, float f) {
+    return ControllerGains {
+      a.kP + (b.kP - a.kP) * f, a.kI + (b.kI - a.kI) * f, a.kD + (b.kD - a.kD) * f,
+      a.kS + (b.kS - a.kS) * f, a.kV + (b.kV - a.kV) * f, a.kA + (b.kA - a.kA) * f,
+    };
+  }
+};
+
+namespace scheduled_detail {
+// the scalar (or packed lanes) a T is made of
+template<typename T> struct Lane { using type = T; };
+template<typename S> struct Lane<Vec2T<S>> { using type = S; };
+
+// lane-wise for packed types, so every lane picks its own side
+template<typename K> inline K lane_min(const K &a, const K &b) { using std::min; return min(a, b); }
+template<typename K> inline K lane_max(const K &a, const K &b) { using std::max; return max(a, b); }
+
+template<typename K> inline K magnitude(const K &v) { using std::abs; return abs(v); }
+template<typename K> inline K magnitude(const Vec2T<K> &v) { return v.length(); }
+
+template<typename K> inline void zero_lane(K &v, size_t lane) {
+  float lanes[K::size()];
+  packed_store(v, lanes);
+  lanes[lane] = 0.0f;
+  v = packed_load<K>(lanes);
+}
+template<typename K> inline void zero_lane(Vec2T<K> &v, size_t lane) {
+  zero_lane(v.x, lane);
+  zero_lane(v.y, lane);
+}
+}
+
+// PIDController with its gains looked up from a GainSchedule every update, and the
+// feedforward built in. T is float or Vec2, or floatx4/floatx8/Vec2x4/Vec2x8 to run one
+// controller per lane, each with its own speed and curvature (and so its own gains).
+//  - derivative on measurement: the D term damps the measured rate against the reference
+//    rate passed in, so a jump in the target (a new path, a restarted routine) doesn't kick
+//  - anti-windup: the accumulated error is clamped to max_integral (error * s), by length for Vec2
+//  - dt <= 0 changes nothing, the output uses the last measured rate
+// Nothing allocates, it's as cheap to run in a batched simulation as in the GUI.
+template<typename T, size_t SPEEDS = 6, size_t CURVATURES = 4>
+struct ScheduledController {
+  using Schedule = GainSchedule<SPEEDS, CURVATURES>;
+  using Lane = typename scheduled_detail::Lane<T>::type;
+
+  // an error of 1 (m, rad) held for a second
+  static constexpr float DEFAULT_MAX_INTEGRAL = 1.0f;
+
+  ScheduledController(const Schedule &schedule = {}, float max_integral = DEFAULT_MAX_INTEGRAL)
+    : schedule(schedule), max_integral(max_integral) {}
+
+  Schedule schedule;
+  float max_integral;
+  ControllerGainsT<Lane> gains; // from the last update, for display
+
+  // `target_rate` and `target_acceleration` are the reference's derivatives (zero for a fixed setpoint)
+  T update(const T &target, const T &current, const T &target_rate, const T &target_acceleration,
+    const Lane &speed, const Lane &curvature, float dt) {
+    using namespace scheduled_detail;
+    this->gains = this->schedule.at(speed, curvature);
+
+    T error = target - current;
+    if (dt > 0.0f) {
+      this->accum_error += error * dt;
+      this->accum_error = this->accum_error * lane_min(Lane(1.0f), Lane(this->max_integral) / lane_max(magnitude(this->accum_error), Lane(1e-9f)));
+
+      // no rate on the first update, there's no previous measurement to take it from
+      this->measured_rate = (current - this->last_current) * (this->primed / dt);
+      this->last_current = current;
+      this->primed = 1.0f;
+    }
+
+    // ramps in over the first mm/s (rad/s) instead of flipping sign around zero
+    T friction = target_rate * (1.0f / lane_max(magnitude(target_rate), Lane(1e-3f)));
+
+    const ControllerGainsT<Lane> &k = this->gains;
+    return k.kP * error + k.kI * this->accum_error + k.kD * (target_rate - this->measured_rate)
+      + k.kS * friction + k.kV * target_rate + k.kA * target_acceleration;
+  }
+
+  void reset() {
+    this->last_current = this->accum_error = this->measured_rate = {};
+    this->primed = 0.0f;
+  }
+
+  // packed T: forgets one lane's accumulated error, its measured rate carries on from the
+  // measurements it has been getting
+  void reset_lane(size_t lane) {
+    scheduled_detail::zero_lane(this->accum_error, lane);
+  }
+private:
+  T last_current = {}, accum_error = {}, measured_rate = {};
+  float primed = 0.0f;
+};
+}
@@ -0,0 +1,70 @@
+/*
+* frc-pathgen/include/sensors.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include "pose_estimator.hpp"
+#include "robot.hpp"
+#include "viewport.hpp"
+#include <array>
+#include <cstdint>
+#include <random>
+
+namespace frc_pathgen {
+
+struct SensorNoise {
+  float odometry_slip = 0.03f;       // 1 sigma, fraction of each wheel odometry step
+  float gyro_noise = 0.002f;         // rad per sample
+  float gyro_bias_walk = 0.001f;     // rad/s per sqrt(s)
+  float vision_position = 0.05f;     // m
+  float vision_heading = 0.02f;      // rad
+  float vision_period = 0.1f;        // s between camera frames
+  float vision_latency = 0.12f;      // s from exposure until the pose arrives
+  float vision_dropout = 0.2f;       // fraction of frames without a target in view
+};
+
+// What the robot would actually know about itself: wheel odometry that slips, a gyro that
+// drifts and vision poses that show up late. tick() samples them from the simulated
+// robot's true state and feeds them to a PoseEstimator.
+class SimulatedSensors {
+public:
+  SimulatedSensors(SensorNoise noise = {}, uint32_t seed = 8193);
+
+  // starts the estimator at the robot's true pose
+  void reset(const Robot &robot, PoseEstimator &estimator);
+  void tick(const Robot &robot, float dt, PoseEstimator &estimator);
+
+  void draw(SDL_Renderer *renderer, const Viewport &viewport, const Robot &robot, const PoseEstimator &estimator);
+private:
+  struct VisionFrame {
+    float captured;
+    float arrives;
+    Pose pose;
+  };
+
+  float gaussian(float stddev);
+
+  SensorNoise noise;
+  std::mt19937 rng;
+  std::normal_distribution<float> normal { 0.0f, 1.0f };
+  std::uniform_real_distribution<float> uniform { 0.0f, 1.0f };
+
+  float time = 0.0f;
+  float gyro_bias = 0.0f;
+  float next_frame = 0.0f;
+
+  // frames in flight, a ring since they arrive in the order they were captured
+  static constexpr size_t IN_FLIGHT = 16;
+  std::array<VisionFrame, IN_FLIGHT> in_flight;
+  size_t in_flight_first = 0, in_flight_count = 0;
+
+  Pose last_vision;
+  bool have_vision = false;
+};
+}
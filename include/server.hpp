@@ -0,0 +1,36 @@
+/*
+* frc-pathgen/include/server.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "trajectory.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+namespace frc_pathgen {
+
+// Wire protocol, all integers and floats little-endian, one connection may carry any number of requests:
+//   request:  u32 length, then `length` bytes of .path text (see path_io.hpp)
+//   response: u32 status, u32 length, then `length` bytes of payload
+//     status 0: u32 count, f32 dt, then count * { f32 t, x, y, vx, vy, kappa, heading, omega }
+//     status 1: utf-8 error message
+struct ServerOptions {
+  std::filesystem::path socket;
+  unsigned int threads = 0; // concurrent connections, 0 = a sensible default. more are refused with an error
+  size_t cache_entries = 256;
+  bool use_disk_cache = true;
+};
+
+// Serves trajectories on a unix socket until SIGINT/SIGTERM. Returns a process exit code.
+// A socket left behind by a previous run is replaced, anything else at the path is an error.
+int run_server(const ServerOptions &options);
+
+// Client side of the protocol: sends one spec, fills `table` or `error`.
+bool query_server(const std::filesystem::path &socket, const std::string &spec, TrajectoryTable &table, std::string &error);
+}
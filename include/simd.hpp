@@ -0,0 +1,86 @@
+/*
+* frc-pathgen/include/simd.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define FRC_PATHGEN_STD_SIMD 1
+#endif
+
+namespace frc_pathgen {
+
+#ifdef FRC_PATHGEN_STD_SIMD
+// lowered to SSE/AVX registers by the compiler, depending on -march
+template<typename T, int N>
+using Packed = std::experimental::fixed_size_simd<T, N>;
+
+template<typename P>
+inline P packed_load(const typename P::value_type *data) {
+  return P(data, std::experimental::element_aligned);
+}
+
+template<typename P>
+inline void packed_store(const P &p, typename P::value_type *data) {
+  p.copy_to(data, std::experimental::element_aligned);
+}
+#else
+// plain lanes for standard libraries without <experimental/simd>, the loops auto-vectorize
+template<typename T, int N>
+struct Packed {
+  using value_type = T;
+  T lanes[N];
+
+  Packed() = default;
+  Packed(T v) { for (int i = 0; i < N; ++i) lanes[i] = v; }
+
+  static constexpr size_t size() { return N; }
+  inline T operator[](size_t i) const { return lanes[i]; }
+
+  #define FRC_PATHGEN_PACKED_OP(op) \
+    inline Packed operator op(const Packed &o) const { Packed r; for (int i = 0; i < N; ++i) r.lanes[i] = lanes[i] op o.lanes[i]; return r; } \
+    inline Packed &operator op##=(const Packed &o) { for (int i = 0; i < N; ++i) lanes[i] op##= o.lanes[i]; return *this; }
+  FRC_PATHGEN_PACKED_OP(+)
+  FRC_PATHGEN_PACKED_OP(-)
+  FRC_PATHGEN_PACKED_OP(*)
+  FRC_PATHGEN_PACKED_OP(/)
+  #undef FRC_PATHGEN_PACKED_OP
+
+  inline Packed operator-() const { Packed r; for (int i = 0; i < N; ++i) r.lanes[i] = -lanes[i]; return r; }
+
+  friend inline Packed operator+(T a, const Packed &b) { return Packed(a) + b; }
+  friend inline Packed operator-(T a, const Packed &b) { return Packed(a) - b; }
+  friend inline Packed operator*(T a, const Packed &b) { return Packed(a) * b; }
+  friend inline Packed operator/(T a, const Packed &b) { return Packed(a) / b; }
+
+  friend inline Packed sqrt(const Packed &p) { Packed r; for (int i = 0; i < N; ++i) r.lanes[i] = std::sqrt(p.lanes[i]); return r; }
+  friend inline Packed abs(const Packed &p) { Packed r; for (int i = 0; i < N; ++i) r.lanes[i] = std::abs(p.lanes[i]); return r; }
+  friend inline Packed min(const Packed &a, const Packed &b) { Packed r; for (int i = 0; i < N; ++i) r.lanes[i] = std::min(a.lanes[i], b.lanes[i]); return r; }
+  friend inline Packed max(const Packed &a, const Packed &b) { Packed r; for (int i = 0; i < N; ++i) r.lanes[i] = std::max(a.lanes[i], b.lanes[i]); return r; }
+};
+
+template<typename P>
+inline P packed_load(const typename P::value_type *data) {
+  P p;
+  for (size_t i = 0; i < P::size(); ++i) p.lanes[i] = data[i];
+  return p;
+}
+
+template<typename P>
+inline void packed_store(const P &p, typename P::value_type *data) {
+  for (size_t i = 0; i < P::size(); ++i) data[i] = p.lanes[i];
+}
+#endif
+
+using floatx4 = Packed<float, 4>;
+using floatx8 = Packed<float, 8>;
+}
@@ -0,0 +1,77 @@
+/*
+* frc-pathgen/include/telemetry.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace frc_pathgen {
+
+struct MinMax {
+  float lo, hi;
+};
+
+// One value per tick, for the whole run, in bounded memory.
+// Level 0 is a ring of the last CAPACITY raw samples; every level above it is a ring of
+// CAPACITY min/max buckets, each summarizing FANOUT buckets of the level below. Old
+// detail falls off the fine levels but stays in the coarse ones, so the whole history is
+// always there at roughly one bucket per pixel. push() is amortized O(1) and never allocates.
+class TelemetryChannel {
+public:
+  static constexpr size_t CAPACITY = 4096;
+  static constexpr size_t FANOUT = 16;
+  static constexpr size_t LEVELS = 5; // the top level spans 4096 * 16^4 samples, 3 days at 1 kHz
+
+  TelemetryChannel(const char *name, uint32_t color);
+
+  void push(float value);
+  void clear();
+
+  inline const char *get_name() const { return this->name; }
+  inline uint32_t get_color() const { return this->color; }
+  // samples pushed since the last clear(), including the ones only summaries remain of
+  inline uint64_t size() const { return this->total; }
+  // first sample still covered by any level
+  uint64_t oldest() const;
+
+  // min/max of samples [begin, end), false if none of it is still stored
+  bool range(uint64_t begin, uint64_t end, MinMax &out) const;
+  // [begin, end) split into `columns` equal slices, cost depends on `columns` not on end - begin
+  void decimate(uint64_t begin, uint64_t end, size_t columns, MinMax *out, bool *valid) const;
+private:
+  // complete buckets at `level`, the newest CAPACITY of them are stored
+  inline uint64_t buckets(size_t level) const { return this->total / this->span[level]; }
+  inline const MinMax &bucket(size_t level, uint64_t index) const {
+    return this->levels[level * CAPACITY + index % CAPACITY];
+  }
+  void merge_range(size_t level, uint64_t begin, uint64_t end, MinMax &out, bool &any) const;
+
+  const char *name;
+  uint32_t color;
+
+  std::vector<MinMax> levels; // LEVELS rings of CAPACITY
+  MinMax partial[LEVELS];     // bucket being filled at each level above 0
+  uint64_t span[LEVELS];      // samples per bucket
+  uint64_t total = 0;
+};
+
+// Draws channels into the current ImGui window as one plot, full width, over their whole
+// history. Each pixel column is the min/max envelope of the samples it covers, so spikes
+// survive decimation. Keeps its own column buffers, drawing doesn't allocate.
+class TelemetryPlot {
+public:
+  static constexpr size_t MAX_COLUMNS = 2048;
+
+  void draw(const char *label, const TelemetryChannel *const *channels, size_t count, float height = 80.0f);
+private:
+  MinMax columns[MAX_COLUMNS];
+  bool valid[MAX_COLUMNS];
+};
+}
@@ -0,0 +1,46 @@
+/*
+* frc-pathgen/include/thread_pool.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace frc_pathgen {
+
+// fixed set of workers pulling jobs off one queue
+class ThreadPool {
+public:
+  // 0 = one worker per hardware thread
+  ThreadPool(unsigned int threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void submit(std::function<void()> job);
+  // blocks until the queue is empty and every worker is idle
+  void wait_idle();
+
+  inline unsigned int size() const { return (unsigned int)this->workers.size(); }
+private:
+  void work();
+
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> jobs;
+  std::mutex mutex;
+  std::condition_variable job_ready;
+  std::condition_variable idle;
+  unsigned int busy = 0;
+  bool stopping = false;
+};
+}
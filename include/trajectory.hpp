@@ -0,0 +1,153 @@
+/*
+* frc-pathgen/include/trajectory.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "vec2.hpp"
+#include "path.hpp"
+#include "robot.hpp"
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+namespace frc_pathgen {
+
+// everything (besides the geometry) that changes the generated profile
+struct TrajectoryConfig {
+  int samples_per_segment = 64; // knots, every path type has closed-form curvature so few are needed
+  float max_velocity = 4.0f; // m/s, free speed cap for straights
+  float max_acceleration = Robot::bot_acceleration; // m/s^2
+  float curvature_margin = 0.9f; // fraction of the centripetal limit we are allowed to use
+  float max_angular_acceleration = Robot::bot_angular_acceleration; // rad/s^2, with every wheel turning
+  float turn_radius = Robot::wheel_dist_m; // m, how far the wheels are from the center
+};
+
+// the robot should face `heading` (radians) at u along a chain of segments, where u is
+// the segment index plus t in it (1.5 is halfway through the second segment)
+struct HeadingWaypoint {
+  float u;
+  float heading;
+};
+
+// top speed through a point of curvature kappa (1/m) before the wheels slip
+float curvature_vmax(float kappa, float max_acceleration = Robot::bot_acceleration, float margin = 0.9f);
+
+// signed curvature of a path at t, same as path.curvature(t)
+float path_curvature(const Path &path, float t);
+
+struct TrajectorySample {
+  float time;
+  Vec2 position;
+  Vec2 velocity;
+  float kappa;
+  float heading = 0.0f; // radians, unwrapped so it interpolates across +-pi
+  float omega = 0.0f;   // rad/s
+};
+
+// a profile resampled at a fixed timestep, which is what followers and files want
+struct TrajectoryTable {
+  float dt = 0.02f;
+  std::vector<TrajectorySample> samples;
+  std::vector<float> segment_start; // time each path segment begins at
+
+  inline float duration() const {
+    return this->samples.empty()? 0.0f : this->samples.back().time;
+  }
+
+  // O(1) lookup, linearly interpolated between the two neighbouring rows
+  TrajectorySample at(float time) const;
+};
+
+// Velocity profile over a chain of path segments.
+// Every segment is sampled at the same number of knots, and the profile is the usual
+// forward (accelerate) / backward (decelerate) pass over the curvature limits.
+// When a single segment changes, update_segment() resamples only that span and runs
+// both passes outward just until they land back on the cached values, so an edit costs
+// the same no matter how long the rest of the chain is.
+//
+// Heading waypoints turn the robot while it drives. Between two waypoints the heading
+// follows a quintic smoothstep in arc length, so it's a fixed function of distance and
+// turning costs d(heading)/ds * v of angular velocity and d2/ds2 * v^2 + d/ds * a of
+// angular acceleration. Both come out of the same four wheels as translation, so the
+// passes solve for speed and rotation together: every knot's speed limit leaves the wheels
+// room to turn, and every interval's acceleration is what's left of the wheel force after
+// the rotation takes its share. Without waypoints the heading stays at 0 and the profile
+// is exactly the translation-only one.
+class Trajectory {
+public:
+  Trajectory(TrajectoryConfig config = {});
+
+  // waypoints in any order, the heading is 0 up to the first one unless it sits at u = 0
+  void set_segments(std::vector<const Path *> segments, std::vector<HeadingWaypoint> headings = {});
+  // re-solves the whole chain
+  void set_headings(std::vector<HeadingWaypoint> headings);
+  // call after segment `index` changed shape
+  void update_segment(size_t index);
+
+  inline const TrajectoryConfig &get_config() const { return this->config; }
+  inline const std::vector<const Path *> &get_segments() const { return this->segments; }
+
+  inline size_t knot_count() const { return this->velocity.size(); }
+  // knots whose velocity was recomputed by the last set/update (for benchmarks)
+  inline size_t last_update_span() const { return this->update_span; }
+
+  float duration() const;
+  float length() const;
+
+  TrajectorySample sample(float time) const;
+  TrajectoryTable to_table(float dt) const;
+private:
+  void sample_segment(size_t index);
+  // knots [begin, end) widened out to the waypoints around them, the span solve_headings() needs
+  void heading_span(size_t &begin, size_t &end) const;
+  // heading and its arc length derivatives, and the combined speed limit, for knots [begin, end)
+  void solve_headings(size_t begin, size_t end);
+  // translation acceleration left over at speed v through interval i, once cornering and turning have their share
+  float acceleration_limit(size_t i, float v) const;
+  size_t forward_pass(size_t begin, size_t min_end);
+  size_t backward_pass(size_t end, size_t min_begin);
+  void update_times(size_t begin, size_t end);
+
+  // state inside interval i (knot i to i+1) after tau seconds
+  TrajectorySample interpolate(size_t i, float tau) const;
+
+  TrajectoryConfig config;
+  std::vector<const Path *> segments;
+
+  // per knot
+  std::vector<Vec2> position;
+  std::vector<Vec2> tangent; // unit
+  std::vector<float> kappa;
+  std::vector<float> heading;
+  std::vector<float> dheading;  // per m
+  std::vector<float> ddheading; // per m^2
+  std::vector<float> vlimit;
+  std::vector<float> vforward;
+  std::vector<float> velocity;
+
+  // per interval
+  std::vector<float> ds;
+  std::vector<float> dt;
+
+  // per segment
+  std::vector<float> segment_duration;
+  std::vector<float> segment_length;
+
+  size_t update_span = 0;
+
+  // knot index and unwrapped heading, sorted, always starts at knot 0
+  std::vector<std::pair<size_t, float>> heading_knots;
+  std::vector<HeadingWaypoint> headings;
+
+  std::vector<float> scratch_t;
+  std::vector<PathPoint> scratch_points;
+};
+
+TrajectoryTable generate_trajectory(const std::vector<const Path *> &segments, const TrajectoryConfig &config = {}, float dt = 0.02f,
+  const std::vector<HeadingWaypoint> &headings = {});
+}
@@ -0,0 +1,65 @@
+/*
+* frc-pathgen/include/trajectory_cache.hpp
+* Copyright (c) 2025 Frederick Ziola et al. (New Lothrop Robotics)
+* Licensed under MIT. see LICENSE file in the repository root.
+*   Use, copy, modify, and distribute as needed, simply credit the original author.
+*   Because we are programmers, not lawyers!
+*/
+
+#pragma once
+
+#include "trajectory.hpp"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace frc_pathgen {
+
+// hash of everything that goes into a generated table: geometry, heading waypoints, robot constants, generator settings
+uint64_t trajectory_key(const std::vector<const Path *> &segments, const TrajectoryConfig &config, float dt,
+  const std::vector<HeadingWaypoint> &headings = {});
+
+// <SDL pref path>/trajectories, shared by the app and the command line modes
+std::filesystem::path default_trajectory_cache_dir();
+
+// Content-addressed store of generated trajectory tables, one file per key.
+// Least recently used files are evicted once the directory grows past max_bytes.
+// Recency survives restarts through the files' modification times.
+class TrajectoryCache {
+public:
+  TrajectoryCache(std::filesystem::path directory, uintmax_t max_bytes = 64ull << 20);
+
+  bool load(uint64_t key, TrajectoryTable &table);
+  void store(uint64_t key, const TrajectoryTable &table);
+
+  TrajectoryTable get_or_generate(const std::vector<const Path *> &segments, const TrajectoryConfig &config = {}, float dt = 0.02f,
+    const std::vector<HeadingWaypoint> &headings = {});
+
+  inline size_t get_hits() const { return this->hits; }
+  inline size_t get_misses() const { return this->misses; }
+  inline uintmax_t get_size_bytes() const { return this->total_bytes; }
+private:
+  struct Entry {
+    uintmax_t size;
+    std::list<uint64_t>::iterator lru_position;
+  };
+
+  std::filesystem::path file_for(uint64_t key) const;
+  void forget(uint64_t key);
+  void evict();
+
+  std::filesystem::path directory;
+  uintmax_t max_bytes;
+  uintmax_t total_bytes = 0;
+
+  std::mutex mutex;
+  std::unordered_map<uint64_t, Entry> entries;
+  std::list<uint64_t> lru; // front is most recent
+
+  std::atomic<size_t> hits = 0, misses = 0;
+};
+}
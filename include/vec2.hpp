@@ -9,27 +9,47 @@
 #pragma once
 
 #include <cmath>
+#include "simd.hpp"
 
 namespace frc_pathgen {
 
-struct Vec2 {
-  float x, y;
+// M_PI isn't standard C++
+constexpr float PI = 3.14159265358979f;
 
-  inline float length() const { return sqrtf(x*x+y*y); }
+// T is float, double, or a Packed lane type (one vector per lane)
+template<typename T>
+struct Vec2T {
+  using scalar = T;
 
-  inline Vec2 operator+(const Vec2& o) const { return {x + o.x, y + o.y}; }
-  inline Vec2 operator-(const Vec2& o) const { return {x - o.x, y - o.y}; }
-  inline Vec2 operator*(float f) const { return {x * f, y * f}; }
-  inline Vec2 operator/(float f) const { return {x / f, y / f}; }
-  inline Vec2& operator+=(const Vec2& o) { x += o.x; y += o.y; return *this; }
-  inline Vec2& operator-=(const Vec2& o) { x -= o.x; y -= o.y; return *this; }
-  inline Vec2& operator*=(const float& o) { x *= o; y *= o; return *this; }
+  T x, y;
 
-  inline static float dot(const Vec2& a, const Vec2& b) { return a.x*b.x+a.y*b.y; }
-  inline static float cross(const Vec2& a, const Vec2& b) { return a.x*b.y-a.y*b.x; }
+  inline T length() const { using std::sqrt; return sqrt(x*x+y*y); }
+
+  inline constexpr Vec2T operator+(const Vec2T& o) const { return {x + o.x, y + o.y}; }
+  inline constexpr Vec2T operator-(const Vec2T& o) const { return {x - o.x, y - o.y}; }
+  inline constexpr Vec2T operator*(T f) const { return {x * f, y * f}; }
+  inline constexpr Vec2T operator/(T f) const { return {x / f, y / f}; }
+  inline constexpr Vec2T& operator+=(const Vec2T& o) { x += o.x; y += o.y; return *this; }
+  inline constexpr Vec2T& operator-=(const Vec2T& o) { x -= o.x; y -= o.y; return *this; }
+  inline constexpr Vec2T& operator*=(const T& o) { x *= o; y *= o; return *this; }
+
+  inline static constexpr T dot(const Vec2T& a, const Vec2T& b) { return a.x*b.x+a.y*b.y; }
+  inline static constexpr T cross(const Vec2T& a, const Vec2T& b) { return a.x*b.y-a.y*b.x; }
 };
 
-inline Vec2 operator*(float a, const Vec2& b) {
+// the scalar is not deduced, so `0.5 * Vec2` still works
+template<typename T>
+inline constexpr Vec2T<T> operator*(typename Vec2T<T>::scalar a, const Vec2T<T>& b) {
   return b*a;
 }
+
+template<typename S, typename T>
+inline constexpr Vec2T<S> vec2_cast(const Vec2T<T>& v) {
+  return Vec2T<S> { S(v.x), S(v.y) };
+}
+
+using Vec2  = Vec2T<float>;
+using Vec2d = Vec2T<double>; // for long paths where float arc length drifts
+using Vec2x4 = Vec2T<floatx4>;
+using Vec2x8 = Vec2T<floatx8>;
 }
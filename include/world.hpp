@@ -11,8 +11,11 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include "viewport.hpp"
+#include "gfx.hpp"
+#include "frame_arena.hpp"
 
 namespace frc_pathgen {
 
-void draw_world_gridlines(SDL_Renderer *renderer, TTF_Font *font, const Viewport &viewport);
+// labels are formatted into the frame arena instead of the heap
+void draw_world_gridlines(SDL_Renderer *renderer, const GlyphAtlas &labels, FrameArena &arena, const Viewport &viewport);
 }